@@ -0,0 +1,54 @@
+// Сложение и вычитание на входах с цепочками переносов и заёмов длиной во всё число:
+// 10^k - 1, (10^k - 1) + 1, 99..9900..00 - 99..99, а также случайные числа. Время в наносекундах
+// на лимб не должно расти с длиной - ядра линейны при любом распределении переносов.
+// Запуск: ./AddSubBench
+#include "BigInteger_Rational.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+template <class Operation>
+double nanosecondsPerLimb(size_t limbs, Operation operation) {
+  size_t iterations = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    operation();
+    ++iterations;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (elapsed < 0.1);
+  return elapsed * 1e9 / static_cast<double>(iterations) / static_cast<double>(limbs);
+}
+
+BigInteger randomLimbs(std::mt19937_64& rng, size_t limbs) {
+  std::string s(9 * limbs, '0');
+  for (char& c : s) {
+    c = static_cast<char>('0' + rng() % 10);
+  }
+  s[0] = '4';
+  return BigInteger(s);
+}
+
+int main() {
+  std::mt19937_64 rng(1);
+  const BigInteger one = 1;
+  std::cout << "ns per limb (copy included)\n";
+  std::cout << "     limbs   10^k - 1  (10^k-1)+1  mixed sub  random add  random sub\n";
+  for (size_t limbs : {100, 1000, 10000, 100000, 1000000}) {
+    BigInteger power = BigInteger(1).shiftLeft(static_cast<int64_t>(limbs));
+    BigInteger nines = power - one;
+    BigInteger mixed = nines;
+    mixed.shiftLeft(static_cast<int64_t>(limbs / 2));
+    BigInteger a = randomLimbs(rng, limbs);
+    BigInteger b = randomLimbs(rng, limbs);
+    volatile bool sink = false;
+    double borrow = nanosecondsPerLimb(limbs, [&] { BigInteger x = power; x -= one; sink = sink ^ bool(x); });
+    double carry = nanosecondsPerLimb(limbs, [&] { BigInteger x = nines; x += one; sink = sink ^ bool(x); });
+    double mixed_sub = nanosecondsPerLimb(limbs, [&] { BigInteger x = mixed; x -= nines; sink = sink ^ bool(x); });
+    double random_add = nanosecondsPerLimb(limbs, [&] { BigInteger x = a; x += b; sink = sink ^ bool(x); });
+    double random_sub = nanosecondsPerLimb(limbs, [&] { BigInteger x = a; x -= b; sink = sink ^ bool(x); });
+    std::printf("  %8zu  %9.2f  %10.2f  %9.2f  %10.2f  %10.2f\n", limbs, borrow, carry, mixed_sub, random_add, random_sub);
+  }
+  return 0;
+}
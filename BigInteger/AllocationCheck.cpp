@@ -0,0 +1,98 @@
+// Проверка, что арифметика над числами до LimbStorage::kInlineLimbs лимбов не выделяет память:
+// буферы лимбов и временные массивы идут через CountingResource, а всё остальное ловит
+// подменённый глобальный operator new. Код возврата 1, если хоть одна операция выделила память
+#include <cstdlib>
+#include <new>
+
+static size_t global_allocations = 0;
+
+// noinline: иначе GCC видит пару malloc/free через встроенные new/delete и ложно предупреждает
+__attribute__((noinline)) void* operator new(size_t size) {
+  ++global_allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p) noexcept {
+  operator delete(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+#include "BigInteger_Rational.cpp"
+
+int failures = 0;
+
+// Выполняет operation под CountingResource и сообщает о любых выделениях
+template <class Operation>
+void expectNoAllocations(const char* name, Operation operation) {
+  CountingResource counter;
+  size_t before = global_allocations;
+  {
+    LimbResourceScope scope(&counter);
+    operation();
+  }
+  size_t global = global_allocations - before;
+  if (counter.allocations() != 0 or global != 0) {
+    std::cout << name << ": " << counter.allocations() << " limb allocations, " << global << " other\n";
+    ++failures;
+  }
+}
+
+int main() {
+  // 36 десятичных цифр - ровно kInlineLimbs лимбов
+  BigInteger big("-123456789012345678901234567890123456");
+  BigInteger a("987654321987654321");
+  BigInteger b("-123456789");
+  BigInteger c(42);
+  volatile bool sink = false;
+
+  expectNoAllocations("construct from int64", [&] { BigInteger x(-1234567890123456789LL); sink = sink ^ bool(x); });
+  expectNoAllocations("copy", [&] { BigInteger x = big; sink = sink ^ bool(x); });
+  expectNoAllocations("move", [&] { BigInteger x = big; BigInteger y = std::move(x); x = std::move(y); });
+  expectNoAllocations("a + b", [&] { BigInteger x = a + b; sink = sink ^ bool(x); });
+  expectNoAllocations("a - big", [&] { BigInteger x = a - big; sink = sink ^ bool(x); });
+  expectNoAllocations("a += b, a -= b", [&] { BigInteger x = a; x += b; x -= b; sink = sink ^ (x == a); });
+  expectNoAllocations("++, --, unary -", [&] { BigInteger x = a; ++x; x--; x = -x; sink = sink ^ bool(x); });
+  expectNoAllocations("a * b", [&] { BigInteger x = a * b; sink = sink ^ bool(x); });
+  expectNoAllocations("a * a", [&] { BigInteger x = a; x *= a; sink = sink ^ bool(x); });
+  expectNoAllocations("big / c, big % c", [&] { BigInteger x = big / c; BigInteger y = big % c; sink = sink ^ (x < y); });
+  expectNoAllocations("big / a, big % a", [&] { BigInteger x = big / a; BigInteger y = big % a; sink = sink ^ (x < y); });
+  expectNoAllocations("big / b", [&] { BigInteger x = big; x /= b; sink = sink ^ bool(x); });
+  expectNoAllocations("gcd", [&] { BigInteger x = gcd(big, a); sink = sink ^ bool(x); });
+  expectNoAllocations("comparisons", [&] {
+    sink = sink ^ (a < b) ^ (a == b) ^ (big != c) ^ (big >= a) ^ (c <= 42) ^ bool(c);
+  });
+
+  // Выходной пакет после первого умножения уже нужной ёмкости
+  BigInteger values[] = {big, a, b, c};
+  BigIntegerBatch batch(values, 4);
+  BigIntegerBatch out;
+  BigIntegerBatch::mul(batch, batch, out);
+  expectNoAllocations("batch add, mul into a reused output", [&] {
+    BigIntegerBatch::add(batch, batch, out);
+    BigIntegerBatch::mul(batch, batch, out);
+  });
+
+  if (failures != 0) {
+    return 1;
+  }
+  std::cout << "OK: no allocations in small-number arithmetic\n";
+  return 0;
+}
@@ -0,0 +1,81 @@
+// BigIntegerBatch против цикла по operator+= и operator*= на count независимых парах чисел
+// по 18, 36 и 72 десятичных цифры (знак первого операнда случайный). Результаты сверяются.
+// Запуск: ./BatchBench [count]; по умолчанию 10^6 пар
+#include "BigInteger_Rational.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+BigInteger randomDigits(std::mt19937_64& rng, size_t digits, bool negative) {
+  std::string s(digits, '0');
+  for (char& c : s) {
+    c = static_cast<char>('0' + rng() % 10);
+  }
+  s[0] = static_cast<char>('1' + rng() % 9);
+  return BigInteger((negative ? "-" : "") + s);
+}
+
+bool sameResults(const BigIntegerBatch& batch, const std::vector<BigInteger>& expected) {
+  for (size_t i = 0; i < expected.size(); ++i) {
+    if (batch[i] != expected[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  size_t count = (argc > 1 ? std::stoull(argv[1]) : 1000000);
+  std::mt19937_64 rng(1);
+  std::cout << count << " pairs, milliseconds\n";
+  std::cout << "  digits   loop +=  batch add   loop *=  batch mul\n";
+  for (size_t digits : {18, 36, 72}) {
+    std::vector<BigInteger> a(count);
+    std::vector<BigInteger> b(count);
+    for (size_t i = 0; i < count; ++i) {
+      a[i] = randomDigits(rng, digits, rng() % 2 == 0);
+      b[i] = randomDigits(rng, digits, false);
+    }
+    std::vector<BigInteger> sums(count);
+    std::vector<BigInteger> products(count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+      sums[i] = a[i];
+      sums[i] += b[i];
+    }
+    double loop_add = millisecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+      products[i] = a[i];
+      products[i] *= b[i];
+    }
+    double loop_mul = millisecondsSince(start);
+
+    BigIntegerBatch batch_a(a.data(), count);
+    BigIntegerBatch batch_b(b.data(), count);
+    BigIntegerBatch batch_sums;
+    BigIntegerBatch batch_products;
+    // Первый проход выделяет выходные массивы, замеряется второй
+    BigIntegerBatch::add(batch_a, batch_b, batch_sums);
+    BigIntegerBatch::mul(batch_a, batch_b, batch_products);
+    start = std::chrono::steady_clock::now();
+    BigIntegerBatch::add(batch_a, batch_b, batch_sums);
+    double batch_add = millisecondsSince(start);
+    start = std::chrono::steady_clock::now();
+    BigIntegerBatch::mul(batch_a, batch_b, batch_products);
+    double batch_mul = millisecondsSince(start);
+
+    if (!sameResults(batch_sums, sums) or !sameResults(batch_products, products)) {
+      std::cout << "batch results differ at " << digits << " digits\n";
+      return 1;
+    }
+    std::printf("  %6zu  %8.1f  %9.1f  %8.1f  %9.1f\n", digits, loop_add, batch_add, loop_mul, batch_mul);
+  }
+  return 0;
+}
@@ -1,13 +1,340 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <initializer_list>
 #include <iostream>
+#include <memory_resource>
+#include <stdexcept>
 #include <vector>
 #include <string>
+#include <thread>
+#include <utility>
+
+// Ядра сложения и вычитания на AVX2 собираются всегда (target("avx2")), а вызываются,
+// только если процессор их поддерживает: флаги компиляции вроде -mavx2 не нужны
+#if defined(__GNUC__) and (defined(__x86_64__) or defined(__i386__))
+#define BIGINTEGER_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+// Ресурс памяти, из которого в текущем потоке выделяются буферы лимбов и временные массивы ядер.
+// По умолчанию это new/delete; на время вычисления его можно заменить, например, на
+// std::pmr::monotonic_buffer_resource и освободить всю память разом.
+// Число, созданное внутри области, держит память её ресурса, и конструктор перемещения
+// забирает буфер вместе с ресурсом: `BigInteger r = std::move(x)` или возврат по значению
+// из области оставляют r в арене. Выносить результат наружу можно только копией или
+// присваиванием в число, созданное вне области (оно скопирует лимбы в свой ресурс)
+class LimbResourceScope {
+ public:
+  explicit LimbResourceScope(std::pmr::memory_resource* resource) : previous_(current_) {
+    current_ = (resource == std::pmr::new_delete_resource() ? nullptr : resource);
+  }
+
+  LimbResourceScope(const LimbResourceScope&) = delete;
+  LimbResourceScope& operator=(const LimbResourceScope&) = delete;
+
+  ~LimbResourceScope() {
+    current_ = previous_;
+  }
+
+  static std::pmr::memory_resource* current() {
+    return (current_ != nullptr ? current_ : std::pmr::new_delete_resource());
+  }
+
+ private:
+  friend class LimbStorage;
+
+  // nullptr - обычные new[]/delete[] без виртуального вызова
+  inline static thread_local std::pmr::memory_resource* current_ = nullptr;
+  std::pmr::memory_resource* previous_;
+};
+
+// Прокладка над upstream, считающая выделения: оберните ей операцию, чтобы узнать её стоимость по памяти
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+      : upstream_(upstream) {}
+
+  size_t allocations() const {
+    return allocations_;
+  }
+
+  size_t deallocations() const {
+    return deallocations_;
+  }
+
+  size_t bytesAllocated() const {
+    return bytes_allocated_;
+  }
+
+  // Наибольший объём одновременно занятой памяти
+  size_t peakBytes() const {
+    return peak_bytes_;
+  }
+
+  void reset() {
+    allocations_ = deallocations_ = bytes_allocated_ = 0;
+    peak_bytes_ = live_bytes_;
+  }
+
+ private:
+  std::pmr::memory_resource* upstream_;
+  size_t allocations_ = 0;
+  size_t deallocations_ = 0;
+  size_t bytes_allocated_ = 0;
+  size_t live_bytes_ = 0;
+  size_t peak_bytes_ = 0;
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    void* result = upstream_->allocate(bytes, alignment);
+    ++allocations_;
+    bytes_allocated_ += bytes;
+    live_bytes_ += bytes;
+    peak_bytes_ = std::max(peak_bytes_, live_bytes_);
+    return result;
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+    ++deallocations_;
+    live_bytes_ -= bytes;
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+// Временный массив ядер из текущего ресурса
+template <typename T>
+using ScratchVector = std::pmr::vector<T>;
+
+// Хранилище лимбов с буфером на kInlineLimbs элементов внутри объекта:
+// куча используется, только когда число в буфер не помещается. Ресурс памяти запоминается при
+// создании (как у std::pmr-контейнеров); перемещение между разными ресурсами копирует лимбы,
+// поэтому присваивание в число, созданное вне арены, безопасно переживает её освобождение
+class LimbStorage {
+ public:
+  static constexpr size_t kInlineLimbs = 4;
+
+  LimbStorage() = default;
+
+  LimbStorage(size_t n, int64_t value) {
+    assign(n, value);
+  }
+
+  LimbStorage(const int64_t* first, const int64_t* last) {
+    assign(first, last);
+  }
+
+  LimbStorage(const LimbStorage& other) {
+    assign(other.begin(), other.end());
+  }
+
+  LimbStorage(LimbStorage&& other) noexcept : resource_(other.resource_) {
+    steal(other);
+  }
+
+  LimbStorage& operator=(const LimbStorage& other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  // Не noexcept: при разных ресурсах лимбы копируются в ресурс *this, и выделение может бросить
+  LimbStorage& operator=(LimbStorage&& other) {
+    if (this != &other) {
+      if (!other.isInline() and resource_ != other.resource_ and
+          (resource_ == nullptr or other.resource_ == nullptr or !resource_->is_equal(*other.resource_))) {
+        assign(other.begin(), other.end());
+        other.size_ = 0;
+        return *this;
+      }
+      release();
+      steal(other);
+    }
+    return *this;
+  }
+
+  ~LimbStorage() {
+    release();
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  int64_t* data() {
+    return data_;
+  }
+
+  const int64_t* data() const {
+    return data_;
+  }
+
+  int64_t* begin() {
+    return data_;
+  }
+
+  const int64_t* begin() const {
+    return data_;
+  }
+
+  int64_t* end() {
+    return data_ + size_;
+  }
+
+  const int64_t* end() const {
+    return data_ + size_;
+  }
+
+  int64_t& operator[](size_t index) {
+    return data_[index];
+  }
+
+  const int64_t& operator[](size_t index) const {
+    return data_[index];
+  }
+
+  int64_t& back() {
+    return data_[size_ - 1];
+  }
+
+  const int64_t& back() const {
+    return data_[size_ - 1];
+  }
+
+  void reserve(size_t n) {
+    if (n > capacity_) {
+      reallocate(std::max(n, 2 * capacity_));
+    }
+  }
+
+  void push_back(int64_t value) {
+    reserve(size_ + 1);
+    data_[size_++] = value;
+  }
+
+  void pop_back() {
+    --size_;
+  }
+
+  void clear() {
+    size_ = 0;
+  }
+
+  void resize(size_t n, int64_t value = 0) {
+    reserve(n);
+    if (n > size_) {
+      std::fill(data_ + size_, data_ + n, value);
+    }
+    size_ = n;
+  }
+
+  void assign(size_t n, int64_t value) {
+    size_ = 0;
+    resize(n, value);
+  }
+
+  // Источник может лежать внутри этого же хранилища: тогда n <= size_ и
+  // перевыделения не происходит
+  void assign(const int64_t* first, const int64_t* last) {
+    size_t n = static_cast<size_t>(last - first);
+    if (n > capacity_) {
+      size_ = 0;
+      reserve(n);
+    }
+    std::copy(first, last, data_);
+    size_ = n;
+  }
+
+  void assign(std::initializer_list<int64_t> values) {
+    assign(values.begin(), values.end());
+  }
+
+  void erase(int64_t* first, int64_t* last) {
+    std::copy(last, end(), first);
+    size_ -= static_cast<size_t>(last - first);
+  }
+
+  void swap(LimbStorage& other) {
+    LimbStorage tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+ private:
+  int64_t* data_ = inline_;
+  size_t size_ = 0;
+  size_t capacity_ = kInlineLimbs;
+  std::pmr::memory_resource* resource_ = LimbResourceScope::current_; // nullptr - new[]/delete[]
+  int64_t inline_[kInlineLimbs];
+
+  bool isInline() const {
+    return data_ == inline_;
+  }
+
+  void reallocate(size_t new_capacity) {
+    int64_t* new_data = (resource_ == nullptr ? new int64_t[new_capacity] :
+        static_cast<int64_t*>(resource_->allocate(new_capacity * sizeof(int64_t), alignof(int64_t))));
+    std::copy(data_, data_ + size_, new_data);
+    deallocate();
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  void deallocate() {
+    if (isInline()) {
+      return;
+    }
+    if (resource_ == nullptr) {
+      delete[] data_;
+    } else {
+      resource_->deallocate(data_, capacity_ * sizeof(int64_t), alignof(int64_t));
+    }
+  }
+
+  void release() {
+    deallocate();
+    data_ = inline_;
+    size_ = 0;
+    capacity_ = kInlineLimbs;
+  }
+
+  void steal(LimbStorage& other) {
+    if (other.isInline()) {
+      std::copy(other.inline_, other.inline_ + other.size_, inline_);
+    } else {
+      data_ = other.data_;
+      capacity_ = other.capacity_;
+      resource_ = other.resource_;
+      other.data_ = other.inline_;
+      other.capacity_ = kInlineLimbs;
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+  }
+};
+
+// Основание лимбов в двоичном формате сериализации: binary - модуль по основанию 2^64
+// (переносимый вид, но нужен перевод системы счисления), decimal - лимбы BigInteger по
+// основанию 10^9 в 32-битных словах, копируются как есть
+enum class WireRadix { binary, decimal };
 
 class BigInteger {
  public:
 
   BigInteger() {
     sign_ = true;
-    digits_ = std::vector<int64_t>();
+    digits_.push_back(0);
   }
 
   BigInteger(const int64_t& a) {
@@ -26,6 +353,27 @@ class BigInteger {
     digits_ = other.digits_;
   }
 
+  BigInteger(BigInteger&& other) noexcept : sign_(other.sign_), digits_(std::move(other.digits_)) {
+    other.sign_ = true;
+    other.digits_.push_back(0);
+  }
+
+  BigInteger& operator=(const BigInteger& other) {
+    sign_ = other.sign_;
+    digits_ = other.digits_;
+    return *this;
+  }
+
+  BigInteger& operator=(BigInteger&& other) {
+    if (this != &other) {
+      sign_ = other.sign_;
+      digits_ = std::move(other.digits_);
+      other.sign_ = true;
+      other.digits_.push_back(0);
+    }
+    return *this;
+  }
+
   static int64_t pow_ten(const size_t& degree) {
     int64_t answer = 1;
     for (size_t j = 0; j < degree; ++j) {
@@ -44,19 +392,7 @@ class BigInteger {
     } else {
       sign_ = true;
     }
-    int64_t tmp = 0;
-    int counter = 0;
-    for (int64_t j = static_cast<int64_t>(s.size()) - 1; j >= (0 + static_cast<int64_t>(with_sign)); --j) {
-      if (counter == 9) {
-        counter = 0;
-        digits_.push_back(tmp);
-        tmp = 0;
-      }
-      tmp += (static_cast<int64_t>(s[j] - '0') * pow_ten(counter));
-      ++counter;
-
-    }
-    digits_.push_back(tmp);
+    parseLimbs(s.data() + static_cast<size_t>(with_sign), s.data() + s.size(), digits_);
     this->clear();
   }
 
@@ -87,18 +423,41 @@ class BigInteger {
     return b;
   }
 
-  std::string toString() {
-    std::string str_int;
+  // Число символов в десятичной записи (вместе со знаком)
+  size_t decimalLength() const {
+    size_t length = 9 * (digits_.size() - 1) + static_cast<size_t>(!sign_);
+    for (int64_t top = digits_.back(); ; top /= 10) {
+      ++length;
+      if (top < 10) { break; }
+    }
+    return length;
+  }
+
+  // Пишет decimalLength() символов начиная с buffer, без выделения памяти
+  char* writeDecimal(char* buffer) const {
     if (!sign_) {
-      str_int += '-';
+      *buffer++ = '-';
     }
-    for (int64_t j = static_cast<int64_t>(digits_.size()) - 1; j >= 0; --j) {
-      if (j != static_cast<int64_t>(digits_.size()) - 1) {
-        str_int += std::to_string(digits_[j] + base).substr(1);
-      } else {
-        str_int += std::to_string(digits_[j]);
+    char* end = buffer + decimalLength() - static_cast<size_t>(!sign_);
+    char* position = end;
+    for (size_t j = 0; j + 1 < digits_.size(); ++j) {
+      int64_t limb = digits_[j];
+      for (int k = 0; k < 9; ++k) {
+        *--position = static_cast<char>('0' + limb % 10);
+        limb /= 10;
       }
     }
+    int64_t top = digits_.back();
+    do {
+      *--position = static_cast<char>('0' + top % 10);
+      top /= 10;
+    } while (top != 0);
+    return end;
+  }
+
+  std::string toString() const {
+    std::string str_int(decimalLength(), '0');
+    writeDecimal(&str_int[0]);
     return str_int;
   }
   BigInteger& operator-=(const BigInteger& other);
@@ -115,13 +474,19 @@ class BigInteger {
   }
 
   BigInteger& shiftLeft(const int64_t& degree) {
-    std::vector<int64_t> tmp = this->digits_;
-    this->digits_.clear();
-    for (int64_t i = 0; i < degree; ++i) {
-      this->digits_.push_back(0);
-    }
-    for (int64_t j = 0; j < static_cast<int64_t>(tmp.size()); ++j) {
-      this->digits_.push_back(tmp[j]);
+    size_t size = this->digits_.size();
+    this->digits_.resize(size + degree);
+    std::copy_backward(this->digits_.begin(), this->digits_.begin() + size, this->digits_.end());
+    std::fill(this->digits_.begin(), this->digits_.begin() + degree, 0);
+    this->clear();
+    return *this;
+  }
+
+  BigInteger& shiftRight(const int64_t& degree) {
+    if (degree >= static_cast<int64_t>(this->digits_.size())) {
+      this->digits_.assign(1, 0);
+    } else {
+      this->digits_.erase(this->digits_.begin(), this->digits_.begin() + degree);
     }
     this->clear();
     return *this;
@@ -144,14 +509,44 @@ class BigInteger {
     return copy;
   }
 
+  // Возведение в квадрат на месте (для больших чисел преобразование NTT делается один раз)
+  BigInteger& square();
+
+  // Пороги (в лимбах) переключения schoolbook -> Карацуба -> Тоом-3 -> NTT
+  inline static size_t karatsuba_threshold = 48;
+  inline static size_t toom3_threshold = 256;
+  inline static size_t ntt_threshold = 2048;
+  // Порог (в лимбах делителя и частного) перехода к делению через обратную величину
+  inline static size_t newton_division_threshold = 2048;
+  // Число потоков для умножения (1 - последовательно) и порог (в лимбах меньшего множителя)
+  inline static size_t threads = 1;
+  inline static size_t parallel_threshold = 8192;
+
  private:
   bool sign_; // Знак числа, false = -; true = положительное
-  std::vector<int64_t> digits_;
-  int64_t base = 1000000000;
+  LimbStorage digits_;
+  static constexpr int64_t base = 1000000000;
 
   friend bool operator<(const BigInteger& a, const BigInteger& b);
   friend std::istream& operator>>(std::istream& in, BigInteger& a);
-  friend std::ostream& operator<<(std::ostream& out, BigInteger a);
+  friend std::ostream& operator<<(std::ostream& out, const BigInteger& a);
+  friend std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value);
+  friend std::to_chars_result serialize(char* first, char* last, const BigInteger& value, WireRadix radix);
+  friend std::from_chars_result deserialize(const char* first, const char* last, BigInteger& value);
+  friend std::pair<BigInteger, BigInteger> divmod(const BigInteger& a, const BigInteger& b);
+  friend BigInteger gcd(const BigInteger& a, const BigInteger& b);
+  friend BigInteger extendedGcd(const BigInteger& a, const BigInteger& b, BigInteger& x, BigInteger& y);
+  friend class BinaryBigInteger;
+  friend class Rational;
+  friend class BigIntegerBatch;
+  template <size_t Bits>
+  friend class FixedBigInt;
+  friend void mul(BigInteger& dest, const BigInteger& a, const BigInteger& b);
+  friend void addmul(BigInteger& dest, const BigInteger& a, const BigInteger& b);
+  friend void submul(BigInteger& dest, const BigInteger& a, const BigInteger& b);
+  friend BigInteger pow(const BigInteger& base, uint64_t exponent);
+  friend BigInteger isqrt(const BigInteger& n);
+  friend BigInteger iroot(const BigInteger& n, uint64_t k);
 
   static bool modCompare(const BigInteger& a, const BigInteger& b) {
     if (a.sign_ and b.sign_) {
@@ -165,6 +560,147 @@ class BigInteger {
     }
   }
 
+  // Ядра над сырыми массивами лимбов, младший лимб первый
+  static int64_t addLimbs(int64_t* a, size_t n, const int64_t* b, size_t m);
+  static int64_t subLimbs(int64_t* a, size_t n, const int64_t* b, size_t m);
+#ifdef BIGINTEGER_AVX2_KERNELS
+  static int64_t addBlocksAvx2(int64_t* a, const int64_t* b, size_t blocks, int64_t carry);
+  static int64_t subBlocksAvx2(int64_t* a, const int64_t* b, size_t blocks, int64_t borrow);
+  inline static const bool has_avx2_ = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+#endif
+  static void mulLimbs(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res);
+  static void mulSchoolbook(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res);
+  static void mulKaratsuba(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res);
+  static void mulToom3(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res);
+  static void mulNTT(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res);
+  static void sqrLimbs(const int64_t* a, size_t n, int64_t* res);
+  static void sqrSchoolbook(const int64_t* a, size_t n, int64_t* res);
+  static void mulParallel(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res, size_t workers);
+  inline static thread_local bool in_parallel_ = false;
+  static int compareLimbs(const int64_t* a, size_t n, const int64_t* b, size_t m);
+  static void mulAccumulate(BigInteger& dest, const BigInteger& a, const BigInteger& b, bool add);
+  void addMagnitude(const int64_t* b, size_t m, bool b_sign);
+  static int64_t divSmallLimbs(int64_t* a, size_t n, int64_t divisor);
+  static void divModLimbs(const int64_t* a, size_t n, const int64_t* b, size_t m,
+                          LimbStorage& quotient, LimbStorage& remainder);
+  static void divMod(const BigInteger& a, const BigInteger& b, BigInteger* quotient, BigInteger* remainder);
+  static BigInteger reciprocal(const BigInteger& b);
+  static void divModNewton(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+  static void combineLimbs(const LimbStorage& u, const LimbStorage& v, int64_t x, int64_t y, LimbStorage& out);
+  static uint64_t binaryGcd(uint64_t a, uint64_t b);
+  static BigInteger gcdLehmer(const BigInteger& a, const BigInteger& b, BigInteger* coefficient);
+
+  static void trimLimbs(LimbStorage& a) {
+    while (a.size() > 1 and a.back() == 0) {
+      a.pop_back();
+    }
+  }
+
+  // Самый короткий из модулей NTT допускает преобразования длины не больше 2^23
+  static constexpr size_t kMaxNTTLength = size_t(1) << 23;
+
+  static uint32_t powMod(uint64_t a, uint64_t degree, uint32_t mod) {
+    uint64_t answer = 1;
+    a %= mod;
+    while (degree != 0) {
+      if (degree & 1) { answer = answer * a % mod; }
+      a = a * a % mod;
+      degree >>= 1;
+    }
+    return static_cast<uint32_t>(answer);
+  }
+
+  // Преобразование на месте по модулю простого mod = c * 2^k + 1 с первообразным корнем 3
+  template <uint32_t mod>
+  static void ntt(ScratchVector<uint32_t>& a, bool invert) {
+    size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+      size_t bit = n >> 1;
+      for (; j & bit; bit >>= 1) { j ^= bit; }
+      j ^= bit;
+      if (i < j) { std::swap(a[i], a[j]); }
+    }
+    ScratchVector<uint32_t> roots(n / 2 + 1, LimbResourceScope::current());
+    for (size_t len = 2; len <= n; len <<= 1) {
+      uint64_t w = powMod(3, (mod - 1) / len, mod);
+      if (invert) { w = powMod(w, mod - 2, mod); }
+      roots[0] = 1;
+      for (size_t j = 1; j < len / 2; ++j) {
+        roots[j] = static_cast<uint32_t>(roots[j - 1] * w % mod);
+      }
+      for (size_t i = 0; i < n; i += len) {
+        for (size_t j = 0; j < len / 2; ++j) {
+          uint32_t u = a[i + j];
+          uint32_t v = static_cast<uint32_t>(uint64_t(a[i + j + len / 2]) * roots[j] % mod);
+          a[i + j] = (u + v >= mod ? u + v - mod : u + v);
+          a[i + j + len / 2] = (u >= v ? u - v : u + mod - v);
+        }
+      }
+    }
+    if (invert) {
+      uint64_t inv_n = powMod(n, mod - 2, mod);
+      for (uint32_t& x : a) { x = static_cast<uint32_t>(x * inv_n % mod); }
+    }
+  }
+
+  // Циклическая свёртка a и b по модулю mod, результат в fa
+  template <uint32_t mod>
+  static void convolution(const int64_t* a, size_t n, const int64_t* b, size_t m, ScratchVector<uint32_t>& fa) {
+    size_t len = fa.size();
+    std::fill(fa.begin(), fa.end(), 0);
+    for (size_t i = 0; i < n; ++i) { fa[i] = static_cast<uint32_t>(a[i] % mod); }
+    ntt<mod>(fa, false);
+    if (a == b and n == m) {
+      for (size_t i = 0; i < len; ++i) { fa[i] = static_cast<uint32_t>(uint64_t(fa[i]) * fa[i] % mod); }
+    } else {
+      ScratchVector<uint32_t> fb(len, 0, LimbResourceScope::current());
+      for (size_t i = 0; i < m; ++i) { fb[i] = static_cast<uint32_t>(b[i] % mod); }
+      ntt<mod>(fb, false);
+      for (size_t i = 0; i < len; ++i) { fa[i] = static_cast<uint32_t>(uint64_t(fa[i]) * fb[i] % mod); }
+    }
+    ntt<mod>(fa, true);
+  }
+
+  // Десятичные цифры [first, last) -> лимбы, по 9 символов с конца
+  static void parseLimbs(const char* first, const char* last, LimbStorage& out) {
+    out.clear();
+    out.reserve((last - first) / 9 + 1);
+    while (last - first > 9) {
+      int64_t limb = 0;
+      for (const char* c = last - 9; c != last; ++c) {
+        limb = limb * 10 + (*c - '0');
+      }
+      out.push_back(limb);
+      last -= 9;
+    }
+    int64_t limb = 0;
+    for (const char* c = first; c != last; ++c) {
+      limb = limb * 10 + (*c - '0');
+    }
+    out.push_back(limb);
+  }
+
+  static BigInteger fromLimbs(const int64_t* a, size_t n) {
+    BigInteger result;
+    if (n == 0) {
+      result.digits_.push_back(0);
+    } else {
+      result.digits_.assign(a, a + n);
+    }
+    result.clear();
+    return result;
+  }
+
+  // Деление модуля на короткое число на месте
+  BigInteger& divSmall(int64_t divisor) {
+    divSmallLimbs(digits_.data(), digits_.size(), divisor);
+    this->clear();
+    return *this;
+  }
+
   void clear() {
     for (int64_t j = static_cast<int64_t>(digits_.size()) - 1; j > 0; --j) {
       if (digits_[j] == 0) {
@@ -186,12 +722,32 @@ BigInteger operator+(const BigInteger& a, const BigInteger& b) {
   return result;
 }
 
+BigInteger operator+(BigInteger&& a, const BigInteger& b) {
+  a += b;
+  return std::move(a);
+}
+
+BigInteger operator+(const BigInteger& a, BigInteger&& b) {
+  b += a;
+  return std::move(b);
+}
+
+BigInteger operator+(BigInteger&& a, BigInteger&& b) {
+  a += b;
+  return std::move(a);
+}
+
 BigInteger operator-(const BigInteger& a, const BigInteger& b) {
   BigInteger result = a;
   result -= b;
   return result;
 }
 
+BigInteger operator-(BigInteger&& a, const BigInteger& b) {
+  a -= b;
+  return std::move(a);
+}
+
 BigInteger operator*(const BigInteger& a, const BigInteger& b) {
   BigInteger result = a;
   result *= b;
@@ -229,97 +785,19 @@ bool operator!=(const BigInteger& a, const BigInteger& b) {
 }
 
 BigInteger& BigInteger::operator+=(const BigInteger& other) {
-  if ((other.sign_ && this->sign_) or (!other.sign_ && !this->sign_)) {
-    uint64_t right_degree = other.digits_.size();
-    uint64_t left_degree = this->digits_.size();
-    uint64_t max_degree = right_degree > left_degree ? right_degree : left_degree;
-    for (uint64_t i = 0; i < max_degree - left_degree; ++i) {
-      this->digits_.push_back(0);
-    }
-    int64_t tmp = 0;
-    for (uint64_t i = 0; i < right_degree; ++i) {
-      tmp += other.digits_[i];
-      tmp += this->digits_[i];
-      this->digits_[i] = (tmp % base);
-      tmp -= (tmp % base);
-      tmp /= base;
-    }
-    for (uint64_t i = right_degree; i < left_degree; ++i) {
-      if (tmp == 0) { break; }
-      tmp += this->digits_[i];
-      this->digits_[i] = (tmp % base);
-      tmp /= base;
-    }
-    if (tmp != 0) { this->digits_.push_back(tmp); }
-    return *this;
-  } else if (this->sign_ and !other.sign_) {
-    return (*this -= (-other));
-  } else {
-    this->sign_ = true;
-    *this -= other;
-    *this = -(*this);
-    return *this;
+  if (&other == this) {
+    return (*this *= 2);
   }
+  this->addMagnitude(other.digits_.data(), other.digits_.size(), other.sign_);
+  return *this;
 }
 
 BigInteger& BigInteger::operator-=(const BigInteger& other) {
-  if (this->sign_ && other.sign_) {
-    if (*this >= other) {
-      bool below_zero = false;
-      int64_t delta = 0;
-      uint64_t max_degree = max(other.digits_.size(), this->digits_.size());
-      if (this->digits_.size() < max_degree) {
-        for (uint64_t i = 0; i < max_degree - this->digits_.size(); ++i) {
-          this->digits_.push_back(0);
-        }
-      }
-      for (uint64_t i = 0; i < other.digits_.size(); ++i) {
-        delta = this->digits_[i] - other.digits_[i];
-        if (delta < 0) {
-          uint64_t degree_debt = i;
-          if (!below_zero) {
-            for (uint64_t j = i + 1; j < max_degree; ++j) {
-              if (this->digits_[j] > 0) {
-                this->digits_[j] = this->digits_[j] - 1;
-                degree_debt = j;
-                break;
-              }
-            }
-          }
-          if (degree_debt == i) { below_zero = true; }
-          if (!below_zero) {
-            for (int64_t j = static_cast<int64_t>(degree_debt) - 1; j > static_cast<int64_t>(i); --j) {
-              this->digits_[j] = (base - 1);
-            }
-            delta += base;
-          }
-          if (below_zero) {
-            delta *= -1;
-            this->sign_ = false;
-          }
-        }
-        digits_[i] = delta;
-      }
-      this->clear();
-      return *this;
-    } else {
-      BigInteger tmp = other;
-      tmp -= *this;
-      *this = tmp;
-      this->clear();
-      this->sign_ = false;
-      return *this;
-    }
-  } else if (!this->sign_ && !other.sign_) {
-    return (*this += (-other));
-  } else if (!this->sign_ && other.sign_) {
-    this->sign_ = true;
-    *this += other;
-    this->sign_ = false;
-    return *this;
-  } else {
-    return (*this += (-other));
+  if (&other == this) {
+    return (*this = 0);
   }
+  this->addMagnitude(other.digits_.data(), other.digits_.size(), !other.sign_);
+  return *this;
 }
 
 bool operator<(const BigInteger& a, const BigInteger& b) {
@@ -361,121 +839,2304 @@ bool operator<(const BigInteger& a, const BigInteger& b) {
 }
 
 BigInteger::operator bool() const {
-  return (*this != BigInteger(0));
+  return !(digits_.size() == 1 and digits_[0] == 0);
 }
 
-BigInteger& BigInteger::operator*=(const BigInteger& other) {
-  this->sign_ = !(this->sign_ xor other.sign_);
-  if (other == 0) {
-    *this = BigInteger(0);
-    return *this;
-  } else if (modCompare(other, BigInteger(base))) {
-    int64_t from_previous = 0;
-    for (int64_t j = 0; j < static_cast<int64_t>(this->digits_.size()); ++j) {
-      int64_t tmp = this->digits_[j] * other.digits_[0];
-      tmp += from_previous;
-      this->digits_[j] = (tmp % base);
-      from_previous = (tmp / base);
-    }
-    if (from_previous != 0) { this->digits_.push_back(from_previous); }
-    this->clear();
-    return *this;
-  } else {
-    BigInteger tmp = *this;
-    *this *= other.digits_[0];
+// a[0..n) += b[0..m), n >= m; возвращает перенос из старшего лимба
+int64_t BigInteger::addLimbs(int64_t* a, size_t n, const int64_t* b, size_t m) {
+  int64_t carry = 0;
+  size_t i = 0;
+#ifdef BIGINTEGER_AVX2_KERNELS
+  if (has_avx2_ and m >= 64) {
+    carry = addBlocksAvx2(a, b, m / 64, carry);
+    i = m / 64 * 64;
+  }
+#endif
+  for (; i < m; ++i) {
+    a[i] += b[i] + carry;
+    carry = (a[i] >= base);
+    if (carry) { a[i] -= base; }
+  }
+  for (; carry != 0 and i < n; ++i) {
+    a[i] += carry;
+    carry = (a[i] >= base);
+    if (carry) { a[i] -= base; }
+  }
+  return carry;
+}
 
-    for (int64_t j = 1; j < static_cast<int64_t>(other.digits_.size()); ++j) {
-      BigInteger tmp1 = tmp;
-      *this += (tmp1 *= other.digits_[j]).shiftLeft(j);
-    }
-    this->clear();
-    return *this;
+// a[0..n) -= b[0..m), n >= m; возвращает заём из старшего лимба
+int64_t BigInteger::subLimbs(int64_t* a, size_t n, const int64_t* b, size_t m) {
+  int64_t borrow = 0;
+  size_t i = 0;
+#ifdef BIGINTEGER_AVX2_KERNELS
+  if (has_avx2_ and m >= 64) {
+    borrow = subBlocksAvx2(a, b, m / 64, borrow);
+    i = m / 64 * 64;
+  }
+#endif
+  for (; i < m; ++i) {
+    a[i] -= b[i] + borrow;
+    borrow = (a[i] < 0);
+    if (borrow) { a[i] += base; }
+  }
+  for (; borrow != 0 and i < n; ++i) {
+    a[i] -= borrow;
+    borrow = (a[i] < 0);
+    if (borrow) { a[i] += base; }
   }
+  return borrow;
 }
 
-BigInteger& BigInteger::operator/=(const BigInteger& other) {
-  if (modCompare(*this, other)) {
-    *this = BigInteger(0);
-    return *this;
-  } else if (other == *this) {
-    *this = BigInteger(1);
-    return *this;
-  } else {
-    bool sign = !(this->sign_ xor other.sign_);
-    this->sign_ = true;
-    int64_t left_degree = static_cast<int64_t>(this->digits_.size());
-    int64_t right_degree = static_cast<int64_t>(other.digits_.size());
-    int64_t delta_degree = left_degree - right_degree;
-    std::vector<int64_t> result(delta_degree + 1, 0);
-    for (int64_t i = delta_degree; i >= 0; --i) {
-      int64_t left_border = 0;
-      int64_t right_border = base;
-      while ((right_border - left_border) > 1) {
-        int64_t middle = (left_border + right_border) / 2;
-        BigInteger tmp = other;
-        tmp.sign_ = true;
-        tmp *= middle;
-        tmp.shiftLeft(i);
-        if (tmp > *this) {
-          right_border = middle;
-        } else {
-          left_border = middle;
-        }
-      }
-      BigInteger delta = other;
-      delta.sign_ = true;
-      *this -= (delta *= left_border).shiftLeft(i);
-      result[i] = left_border;
+#ifdef BIGINTEGER_AVX2_KERNELS
+// a[0..64 * blocks) += b[0..64 * blocks) блоками по 64 лимба. Суммы и маски считаются по 4 лимба
+// за раз, а переносы внутри блока разрешаются одним сложением масок:
+// generate - сумма >= base, propagate - сумма == base - 1 (пропускает входящий перенос)
+__attribute__((target("avx2")))
+int64_t BigInteger::addBlocksAvx2(int64_t* a, const int64_t* b, size_t blocks, int64_t carry) {
+  const __m256i top = _mm256_set1_epi64x(base - 1);
+  const __m256i base_vector = _mm256_set1_epi64x(base);
+  const __m256i lanes = _mm256_setr_epi64x(0, 1, 2, 3);
+  const __m256i one = _mm256_set1_epi64x(1);
+  for (; blocks != 0; --blocks, a += 64, b += 64) {
+    uint64_t generate = 0;
+    uint64_t propagate = 0;
+    for (size_t k = 0; k < 64; k += 4) {
+      __m256i sum = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), sum);
+      generate |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(sum, top)))) << k;
+      propagate |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(sum, top)))) << k;
+    }
+    uint64_t carries = (generate << 1) | static_cast<uint64_t>(carry);
+    uint64_t incoming = (carries + propagate) ^ propagate;
+    carry = static_cast<int64_t>((generate >> 63) | static_cast<uint64_t>(carries + propagate < carries));
+    for (size_t k = 0; k < 64; k += 4) {
+      __m256i bits = _mm256_and_si256(_mm256_srlv_epi64(_mm256_set1_epi64x(static_cast<int64_t>(incoming >> k)), lanes), one);
+      __m256i sum = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k)), bits);
+      sum = _mm256_sub_epi64(sum, _mm256_and_si256(_mm256_cmpgt_epi64(sum, top), base_vector));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), sum);
     }
-    this->digits_ = result;
-    this->sign_ = sign;
-    this->clear();
-    return *this;
   }
+  return carry;
 }
 
-BigInteger& BigInteger::operator%=(const BigInteger& other) {
-  *this = *this - (other * (*this / other));
-  return *this;
+// Как addBlocksAvx2: generate - разность < 0, propagate - разность == 0
+__attribute__((target("avx2")))
+int64_t BigInteger::subBlocksAvx2(int64_t* a, const int64_t* b, size_t blocks, int64_t borrow) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i base_vector = _mm256_set1_epi64x(base);
+  const __m256i lanes = _mm256_setr_epi64x(0, 1, 2, 3);
+  const __m256i one = _mm256_set1_epi64x(1);
+  for (; blocks != 0; --blocks, a += 64, b += 64) {
+    uint64_t generate = 0;
+    uint64_t propagate = 0;
+    for (size_t k = 0; k < 64; k += 4) {
+      __m256i difference = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k)),
+                                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), difference);
+      generate |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(difference))) << k;
+      propagate |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(difference, zero)))) << k;
+    }
+    uint64_t borrows = (generate << 1) | static_cast<uint64_t>(borrow);
+    uint64_t incoming = (borrows + propagate) ^ propagate;
+    borrow = static_cast<int64_t>((generate >> 63) | static_cast<uint64_t>(borrows + propagate < borrows));
+    for (size_t k = 0; k < 64; k += 4) {
+      __m256i bits = _mm256_and_si256(_mm256_srlv_epi64(_mm256_set1_epi64x(static_cast<int64_t>(incoming >> k)), lanes), one);
+      __m256i difference = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k)), bits);
+      difference = _mm256_add_epi64(difference, _mm256_and_si256(_mm256_cmpgt_epi64(zero, difference), base_vector));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + k), difference);
+    }
+  }
+  return borrow;
+}
+#endif
+
+// res[0..n+m) должен быть обнулён
+void BigInteger::mulSchoolbook(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res) {
+  for (size_t i = 0; i < n; ++i) {
+    if (a[i] == 0) { continue; }
+    int64_t carry = 0;
+    for (size_t j = 0; j < m; ++j) {
+      int64_t tmp = res[i + j] + a[i] * b[j] + carry;
+      res[i + j] = tmp % base;
+      carry = tmp / base;
+    }
+    for (size_t k = i + m; carry != 0; ++k) {
+      int64_t tmp = res[k] + carry;
+      res[k] = tmp % base;
+      carry = tmp / base;
+    }
+  }
 }
 
-std::istream& operator>>(std::istream& in, BigInteger& a) {
-  std::string str_in;
-  in >> str_in;
-  a = BigInteger(str_in);
-  return in;
+void BigInteger::mulLimbs(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res) {
+  while (n > 0 and a[n - 1] == 0) { --n; }
+  while (m > 0 and b[m - 1] == 0) { --m; }
+  if (n < m) {
+    std::swap(a, b);
+    std::swap(n, m);
+  }
+  if (m == 0) {
+    return;
+  }
+  if (threads > 1 and m >= parallel_threshold and !in_parallel_) {
+    mulParallel(a, n, b, m, res, threads);
+  } else if (m < karatsuba_threshold) {
+    mulSchoolbook(a, n, b, m, res);
+  } else if (m >= ntt_threshold and n + m <= kMaxNTTLength) {
+    mulNTT(a, n, b, m, res);
+  } else if (2 * m <= n + 1) {
+    // Несбалансированный случай: режем длинный множитель на куски длины m
+    ScratchVector<int64_t> part(2 * m, LimbResourceScope::current());
+    for (size_t i = 0; i < n; i += m) {
+      size_t len = std::min(m, n - i);
+      std::fill(part.begin(), part.end(), 0);
+      mulLimbs(a + i, len, b, m, part.data());
+      addLimbs(res + i, n + m - i, part.data(), len + m);
+    }
+  } else if (m < toom3_threshold or m <= 2 * ((n + 2) / 3)) {
+    mulKaratsuba(a, n, b, m, res);
+  } else {
+    mulToom3(a, n, b, m, res);
+  }
 }
 
-std::ostream& operator<<(std::ostream& out, BigInteger a) {
-  out << a.toString();
+// Множители режутся на сетку p x q блоков (p * q == workers), произведения пар блоков
+// считаются параллельно и затем последовательно складываются в res
+void BigInteger::mulParallel(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res, size_t workers) {
+  // Выбираем q | workers, минимизирующее длину одной задачи n / p + m / q
+  size_t p = workers;
+  size_t q = 1;
+  for (size_t d = 1; d <= workers; ++d) {
+    if (workers % d != 0 or workers / d > n or d > m) { continue; }
+    if (static_cast<double>(n) * d / workers + static_cast<double>(m) / d <
+        static_cast<double>(n) * q / workers + static_cast<double>(m) / q) {
+      p = workers / d;
+      q = d;
+    }
+  }
+  size_t block_a = (n + p - 1) / p;
+  size_t block_b = (m + q - 1) / q;
+  std::vector<std::vector<int64_t>> parts(p * q);
+  std::atomic<size_t> next(0);
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  auto work = [&]() {
+    bool previous = in_parallel_;
+    in_parallel_ = true;
+    for (size_t task = next++; task < p * q; task = next++) {
+      size_t i = task / q * block_a;
+      size_t j = task % q * block_b;
+      if (i >= n or j >= m) { continue; }
+      size_t len_a = std::min(block_a, n - i);
+      size_t len_b = std::min(block_b, m - j);
+      try {
+        parts[task].assign(len_a + len_b, 0);
+        mulLimbs(a + i, len_a, b + j, len_b, parts[task].data());
+      } catch (...) {
+        if (!failed.exchange(true)) { error = std::current_exception(); }
+      }
+    }
+    in_parallel_ = previous;
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+  for (size_t t = 1; t < workers; ++t) {
+    try {
+      pool.emplace_back(work);
+    } catch (const std::system_error&) {
+      break; // Оставшиеся задачи доделает текущий поток
+    }
+  }
+  work();
+  for (std::thread& thread : pool) { thread.join(); }
+  if (error) { std::rethrow_exception(error); }
+
+  for (size_t task = 0; task < p * q; ++task) {
+    size_t offset = task / q * block_a + task % q * block_b;
+    size_t len = parts[task].size();
+    while (len > 0 and parts[task][len - 1] == 0) { --len; }
+    if (len > 0) {
+      addLimbs(res + offset, n + m - offset, parts[task].data(), len);
+    }
+  }
+}
+
+// n >= m > (n + 1) / 2
+void BigInteger::mulKaratsuba(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res) {
+  size_t h = (n + 1) / 2;
+  mulLimbs(a, h, b, h, res);
+  mulLimbs(a + h, n - h, b + h, m - h, res + 2 * h);
+
+  ScratchVector<int64_t> sum_a(a, a + h, LimbResourceScope::current());
+  sum_a.push_back(addLimbs(sum_a.data(), h, a + h, n - h));
+  ScratchVector<int64_t> sum_b(b, b + h, LimbResourceScope::current());
+  sum_b.push_back(addLimbs(sum_b.data(), h, b + h, m - h));
+
+  ScratchVector<int64_t> middle(2 * h + 2, 0, LimbResourceScope::current());
+  mulLimbs(sum_a.data(), h + 1, sum_b.data(), h + 1, middle.data());
+  subLimbs(middle.data(), middle.size(), res, 2 * h);
+  subLimbs(middle.data(), middle.size(), res + 2 * h, n + m - 2 * h);
+  size_t len = middle.size();
+  while (len > 0 and middle[len - 1] == 0) { --len; }
+  addLimbs(res + h, n + m - h, middle.data(), len);
+}
+
+// n >= m, оба множителя режутся на три части длины k (схема Бодрато)
+void BigInteger::mulToom3(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res) {
+  size_t k = (n + 2) / 3;
+  BigInteger a0 = fromLimbs(a, k), a1 = fromLimbs(a + k, k), a2 = fromLimbs(a + 2 * k, n - 2 * k);
+  BigInteger b0 = fromLimbs(b, k), b1 = fromLimbs(b + k, k), b2 = fromLimbs(b + 2 * k, m - 2 * k);
+
+  auto multiply = [](const BigInteger& x, const BigInteger& y) {
+    BigInteger result;
+    result.digits_.assign(x.digits_.size() + y.digits_.size(), 0);
+    mulLimbs(x.digits_.data(), x.digits_.size(), y.digits_.data(), y.digits_.size(), result.digits_.data());
+    result.sign_ = !(x.sign_ xor y.sign_);
+    result.clear();
+    return result;
+  };
+
+  BigInteger pa = a0 + a2;
+  BigInteger pb = b0 + b2;
+  BigInteger r0 = multiply(a0, b0);
+  BigInteger r1 = multiply(pa + a1, pb + b1);
+  BigInteger rm1 = multiply(pa - a1, pb - b1);
+  BigInteger rm2 = multiply((pa - a1 + a2) * 2 - a0, (pb - b1 + b2) * 2 - b0);
+  BigInteger r4 = multiply(a2, b2);
+
+  BigInteger r3 = (rm2 - r1).divSmall(3);
+  BigInteger r1_new = (r1 - rm1).divSmall(2);
+  BigInteger r2 = rm1 - r0;
+  r3 = (r2 - r3).divSmall(2) + r4 * 2;
+  r2 += r1_new - r4;
+  r1_new -= r3;
+
+  const BigInteger* parts[] = {&r0, &r1_new, &r2, &r3, &r4};
+  for (size_t i = 0; i < 5; ++i) {
+    const LimbStorage& limbs = parts[i]->digits_;
+    size_t len = limbs.size();
+    while (len > 0 and limbs[len - 1] == 0) { --len; }
+    if (len > 0) {
+      addLimbs(res + i * k, n + m - i * k, limbs.data(), len);
+    }
+  }
+}
+
+// Три NTT по модулям ~2^30 и восстановление коэффициентов по КТО (Гарнер):
+// произведение модулей ~7.8e25 покрывает свёртку до 2^23 лимбов < 1e9
+void BigInteger::mulNTT(const int64_t* a, size_t n, const int64_t* b, size_t m, int64_t* res) {
+  static constexpr uint32_t kMod1 = 998244353;
+  static constexpr uint32_t kMod2 = 167772161;
+  static constexpr uint32_t kMod3 = 469762049;
+  size_t len = 1;
+  while (len < n + m) { len <<= 1; }
+  ScratchVector<uint32_t> r1(len, LimbResourceScope::current()), r2(len, LimbResourceScope::current()), r3(len, LimbResourceScope::current());
+  convolution<kMod1>(a, n, b, m, r1);
+  convolution<kMod2>(a, n, b, m, r2);
+  convolution<kMod3>(a, n, b, m, r3);
+
+  const uint64_t inv_m1_mod2 = powMod(kMod1, kMod2 - 2, kMod2);
+  const uint64_t inv_m1_mod3 = powMod(kMod1, kMod3 - 2, kMod3);
+  const uint64_t inv_m2_mod3 = powMod(kMod2, kMod3 - 2, kMod3);
+  const unsigned __int128 m1m2 = static_cast<unsigned __int128>(kMod1) * kMod2;
+  unsigned __int128 carry = 0;
+  for (size_t i = 0; i < n + m; ++i) {
+    uint64_t x1 = r1[i];
+    uint64_t x2 = (r2[i] + kMod2 - x1 % kMod2) % kMod2 * inv_m1_mod2 % kMod2;
+    uint64_t x3 = (r3[i] + kMod3 - x1 % kMod3) % kMod3 * inv_m1_mod3 % kMod3;
+    x3 = (x3 + kMod3 - x2 % kMod3) % kMod3 * inv_m2_mod3 % kMod3;
+    carry += x1 + static_cast<unsigned __int128>(x2) * kMod1 + x3 * m1m2;
+    res[i] = static_cast<int64_t>(carry % base);
+    carry /= base;
+  }
+}
+
+// res[0..2n) должен быть обнулён: сначала удвоенные попарные произведения a[i] * a[j], i < j,
+// затем диагональ a[i]^2 - примерно вдвое меньше умножений, чем в mulSchoolbook
+void BigInteger::sqrSchoolbook(const int64_t* a, size_t n, int64_t* res) {
+  for (size_t i = 0; i + 1 < n; ++i) {
+    if (a[i] == 0) { continue; }
+    int64_t carry = 0;
+    for (size_t j = i + 1; j < n; ++j) {
+      int64_t tmp = res[i + j] + a[i] * a[j] + carry;
+      res[i + j] = tmp % base;
+      carry = tmp / base;
+    }
+    for (size_t k = i + n; carry != 0; ++k) {
+      int64_t tmp = res[k] + carry;
+      res[k] = tmp % base;
+      carry = tmp / base;
+    }
+  }
+  int64_t carry = 0;
+  for (size_t k = 0; k < 2 * n; ++k) {
+    int64_t tmp = 2 * res[k] + carry;
+    res[k] = tmp % base;
+    carry = tmp / base;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    int64_t tmp = res[2 * i] + a[i] * a[i] + carry;
+    res[2 * i] = tmp % base;
+    tmp = res[2 * i + 1] + tmp / base;
+    res[2 * i + 1] = tmp % base;
+    carry = tmp / base;
+  }
+}
+
+// Как mulLimbs(a, n, a, n, res), но Карацуба делает три возведения в квадрат вместо умножений,
+// а NTT - одно прямое преобразование на модуль
+void BigInteger::sqrLimbs(const int64_t* a, size_t n, int64_t* res) {
+  while (n > 0 and a[n - 1] == 0) { --n; }
+  if (n == 0) {
+    return;
+  }
+  if (n < karatsuba_threshold) {
+    sqrSchoolbook(a, n, res);
+    return;
+  }
+  if ((threads > 1 and n >= parallel_threshold and !in_parallel_) or
+      (n >= ntt_threshold and 2 * n <= kMaxNTTLength)) {
+    mulLimbs(a, n, a, n, res);
+    return;
+  }
+  size_t h = (n + 1) / 2;
+  sqrLimbs(a, h, res);
+  sqrLimbs(a + h, n - h, res + 2 * h);
+
+  ScratchVector<int64_t> sum(a, a + h, LimbResourceScope::current());
+  sum.push_back(addLimbs(sum.data(), h, a + h, n - h));
+  ScratchVector<int64_t> middle(2 * h + 2, 0, LimbResourceScope::current());
+  sqrLimbs(sum.data(), h + 1, middle.data());
+  subLimbs(middle.data(), middle.size(), res, 2 * h);
+  subLimbs(middle.data(), middle.size(), res + 2 * h, 2 * n - 2 * h);
+  size_t len = middle.size();
+  while (len > 0 and middle[len - 1] == 0) { --len; }
+  addLimbs(res + h, 2 * n - h, middle.data(), len);
+}
+
+BigInteger& BigInteger::square() {
+  LimbStorage result(2 * this->digits_.size(), 0);
+  sqrLimbs(this->digits_.data(), this->digits_.size(), result.data());
+  this->digits_.swap(result);
+  this->sign_ = true;
+  this->clear();
+  return *this;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& other) {
+  this->sign_ = !(this->sign_ xor other.sign_);
+  if (other.digits_.size() == 1) {
+    int64_t from_previous = 0;
+    for (int64_t j = 0; j < static_cast<int64_t>(this->digits_.size()); ++j) {
+      int64_t tmp = this->digits_[j] * other.digits_[0];
+      tmp += from_previous;
+      this->digits_[j] = (tmp % base);
+      from_previous = (tmp / base);
+    }
+    if (from_previous != 0) { this->digits_.push_back(from_previous); }
+    this->clear();
+    return *this;
+  }
+  LimbStorage result(this->digits_.size() + other.digits_.size(), 0);
+  mulLimbs(this->digits_.data(), this->digits_.size(), other.digits_.data(), other.digits_.size(), result.data());
+  this->digits_.swap(result);
+  this->clear();
+  return *this;
+}
+
+// *this += |b| со знаком b_sign; b не должен указывать внутрь digits_
+void BigInteger::addMagnitude(const int64_t* b, size_t m, bool b_sign) {
+  while (m > 0 and b[m - 1] == 0) { --m; }
+  size_t n = this->digits_.size();
+  if (!*this) {
+    this->sign_ = b_sign;
+  }
+  if (this->sign_ == b_sign) {
+    if (n < m) { this->digits_.resize(m, 0); }
+    int64_t carry = addLimbs(this->digits_.data(), this->digits_.size(), b, m);
+    if (carry != 0) { this->digits_.push_back(carry); }
+  } else if (compareLimbs(this->digits_.data(), n, b, m) >= 0) {
+    subLimbs(this->digits_.data(), n, b, m);
+  } else {
+    LimbStorage result(b, b + m);
+    subLimbs(result.data(), m, this->digits_.data(), n);
+    this->digits_.swap(result);
+    this->sign_ = b_sign;
+  }
+  this->clear();
+}
+
+// dest += a * b (add == true) или dest -= a * b. Если знаки совпадают и множители
+// короткие, произведение накапливается прямо в лимбах dest без временного буфера
+void BigInteger::mulAccumulate(BigInteger& dest, const BigInteger& a, const BigInteger& b, bool add) {
+  bool product_sign = (!(a.sign_ xor b.sign_) == add);
+  size_t n = a.digits_.size();
+  size_t m = b.digits_.size();
+  bool aliased = (&dest == &a or &dest == &b);
+  if (!aliased and (dest.sign_ == product_sign or !dest) and std::min(n, m) < karatsuba_threshold) {
+    dest.sign_ = product_sign;
+    dest.digits_.resize(std::max(dest.digits_.size(), n + m) + 1, 0);
+    mulSchoolbook(a.digits_.data(), n, b.digits_.data(), m, dest.digits_.data());
+    dest.clear();
+    return;
+  }
+  LimbStorage product(n + m, 0);
+  mulLimbs(a.digits_.data(), n, b.digits_.data(), m, product.data());
+  dest.addMagnitude(product.data(), n + m, product_sign);
+}
+
+// dest = a * b с переиспользованием памяти dest
+void mul(BigInteger& dest, const BigInteger& a, const BigInteger& b) {
+  if (&dest == &a or &dest == &b) {
+    dest *= (&dest == &a ? b : a);
+    return;
+  }
+  dest.digits_.assign(a.digits_.size() + b.digits_.size(), 0);
+  BigInteger::mulLimbs(a.digits_.data(), a.digits_.size(), b.digits_.data(), b.digits_.size(), dest.digits_.data());
+  dest.sign_ = !(a.sign_ xor b.sign_);
+  dest.clear();
+}
+
+void addmul(BigInteger& dest, const BigInteger& a, const BigInteger& b) {
+  BigInteger::mulAccumulate(dest, a, b, true);
+}
+
+void submul(BigInteger& dest, const BigInteger& a, const BigInteger& b) {
+  BigInteger::mulAccumulate(dest, a, b, false);
+}
+
+// a * b + c за один результирующий буфер
+BigInteger fma(const BigInteger& a, const BigInteger& b, const BigInteger& c) {
+  BigInteger result = c;
+  addmul(result, a, b);
+  return result;
+}
+
+// Сравнение модулей без учёта ведущих нулей: -1, 0 или 1
+int BigInteger::compareLimbs(const int64_t* a, size_t n, const int64_t* b, size_t m) {
+  while (n > 0 and a[n - 1] == 0) { --n; }
+  while (m > 0 and b[m - 1] == 0) { --m; }
+  if (n != m) {
+    return (n < m ? -1 : 1);
+  }
+  for (size_t j = n; j-- > 0;) {
+    if (a[j] != b[j]) {
+      return (a[j] < b[j] ? -1 : 1);
+    }
+  }
+  return 0;
+}
+
+// a[0..n) /= divisor на месте, возвращает остаток
+int64_t BigInteger::divSmallLimbs(int64_t* a, size_t n, int64_t divisor) {
+  int64_t remainder = 0;
+  for (size_t j = n; j-- > 0;) {
+    int64_t tmp = remainder * base + a[j];
+    a[j] = tmp / divisor;
+    remainder = tmp % divisor;
+  }
+  return remainder;
+}
+
+// Алгоритм D Кнута: n >= m >= 2, b[m - 1] != 0
+void BigInteger::divModLimbs(const int64_t* a, size_t n, const int64_t* b, size_t m,
+                             LimbStorage& quotient, LimbStorage& remainder) {
+  // Нормализация: старший лимб делителя становится >= base / 2
+  int64_t d = base / (b[m - 1] + 1);
+  // Нормализованные копии небольших чисел живут на стеке: деление в пределах
+  // inline-буфера LimbStorage не выделяет память
+  constexpr size_t kStackLimbs = 2 * LimbStorage::kInlineLimbs;
+  int64_t stack_u[kStackLimbs + 1];
+  int64_t stack_v[kStackLimbs];
+  ScratchVector<int64_t> heap_u(LimbResourceScope::current());
+  ScratchVector<int64_t> heap_v(LimbResourceScope::current());
+  int64_t* u = stack_u;
+  int64_t* v = stack_v;
+  if (n > kStackLimbs) {
+    heap_u.resize(n + 1);
+    u = heap_u.data();
+  }
+  if (m > kStackLimbs) {
+    heap_v.resize(m);
+    v = heap_v.data();
+  }
+  int64_t carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    int64_t tmp = a[i] * d + carry;
+    u[i] = tmp % base;
+    carry = tmp / base;
+  }
+  u[n] = carry;
+  carry = 0;
+  for (size_t i = 0; i < m; ++i) {
+    int64_t tmp = b[i] * d + carry;
+    v[i] = tmp % base;
+    carry = tmp / base;
+  }
+
+  quotient.assign(n - m + 1, 0);
+  for (size_t j = n - m + 1; j-- > 0;) {
+    int64_t top = u[j + m] * base + u[j + m - 1];
+    int64_t q_hat = top / v[m - 1];
+    int64_t r_hat = top % v[m - 1];
+    while (q_hat >= base or q_hat * v[m - 2] > r_hat * base + u[j + m - 2]) {
+      --q_hat;
+      r_hat += v[m - 1];
+      if (r_hat >= base) { break; }
+    }
+
+    int64_t borrow = 0;
+    carry = 0;
+    for (size_t i = 0; i < m; ++i) {
+      int64_t product = q_hat * v[i] + carry;
+      carry = product / base;
+      int64_t tmp = u[i + j] - product % base - borrow;
+      borrow = (tmp < 0);
+      u[i + j] = (borrow ? tmp + base : tmp);
+    }
+    u[j + m] -= carry + borrow;
+    if (u[j + m] < 0) {
+      // q_hat оказалось на единицу больше: возвращаем делитель обратно
+      --q_hat;
+      u[j + m] += addLimbs(u + j, m, v, m);
+    }
+    quotient[j] = q_hat;
+  }
+
+  divSmallLimbs(u, m, d);
+  remainder.assign(u, u + m);
+}
+
+// floor(base^(2t) / b), где t - число лимбов b > 0. Точность удваивается рекурсивно:
+// обратная к старшим h = t / 2 + 2 лимбам, один шаг Ньютона и точная доводка остатком
+BigInteger BigInteger::reciprocal(const BigInteger& b) {
+  static constexpr size_t kBaseCase = 32;
+  size_t t = b.digits_.size();
+  BigInteger power = BigInteger(1).shiftLeft(2 * t);
+  if (t == 1) {
+    return power.divSmall(b.digits_[0]);
+  } else if (t <= kBaseCase) {
+    BigInteger result;
+    LimbStorage remainder;
+    divModLimbs(power.digits_.data(), power.digits_.size(), b.digits_.data(), t, result.digits_, remainder);
+    result.sign_ = true;
+    result.clear();
+    return result;
+  }
+  size_t h = t / 2 + 2;
+  size_t l = t - h;
+  BigInteger x = reciprocal(fromLimbs(b.digits_.data() + l, h)).shiftLeft(l);
+  BigInteger error = power - b * x;
+  x += (x * error).shiftRight(2 * t);
+  BigInteger remainder = power - b * x;
+  while (!remainder.sign_) {
+    --x;
+    remainder += b;
+  }
+  while (remainder >= b) {
+    ++x;
+    remainder -= b;
+  }
+  return x;
+}
+
+// a >= 0, b > 0: a режется на блоки по m лимбов, частное каждого блока
+// получается умножением на обратную величину с поправкой не больше чем на 2
+void BigInteger::divModNewton(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder) {
+  size_t n = a.digits_.size();
+  size_t m = b.digits_.size();
+  BigInteger inverse = reciprocal(b);
+  LimbStorage result(n, 0);
+  remainder = BigInteger(0);
+  for (size_t blocks = (n + m - 1) / m; blocks-- > 0;) {
+    size_t low = blocks * m;
+    size_t len = std::min(m, n - low);
+    BigInteger current = remainder;
+    current.shiftLeft(len);
+    current += fromLimbs(a.digits_.data() + low, len);
+    BigInteger q = current * inverse;
+    q.shiftRight(2 * m);
+    remainder = current - q * b;
+    while (remainder >= b) {
+      ++q;
+      remainder -= b;
+    }
+    std::copy(q.digits_.begin(), q.digits_.end(), result.begin() + low);
+  }
+  quotient.digits_.swap(result);
+  quotient.sign_ = true;
+  quotient.clear();
+}
+
+// Деление с остатком с округлением к нулю: знак остатка совпадает со знаком a
+void BigInteger::divMod(const BigInteger& a, const BigInteger& b, BigInteger* quotient, BigInteger* remainder) {
+  bool quotient_sign = !(a.sign_ xor b.sign_);
+  bool remainder_sign = a.sign_;
+  LimbStorage q;
+  LimbStorage r;
+  size_t n = a.digits_.size();
+  size_t m = b.digits_.size();
+  if (compareLimbs(a.digits_.data(), n, b.digits_.data(), m) < 0) {
+    q.assign(1, 0);
+    r = a.digits_;
+  } else if (m == 1) {
+    q = a.digits_;
+    r.assign(1, divSmallLimbs(q.data(), n, b.digits_[0]));
+  } else if (m >= newton_division_threshold and n - m >= newton_division_threshold) {
+    BigInteger abs_a = a;
+    BigInteger abs_b = b;
+    abs_a.sign_ = abs_b.sign_ = true;
+    BigInteger quotient_abs;
+    BigInteger remainder_abs;
+    divModNewton(abs_a, abs_b, quotient_abs, remainder_abs);
+    q.swap(quotient_abs.digits_);
+    r.swap(remainder_abs.digits_);
+  } else {
+    divModLimbs(a.digits_.data(), n, b.digits_.data(), m, q, r);
+  }
+  if (quotient != nullptr) {
+    quotient->digits_.swap(q);
+    quotient->sign_ = quotient_sign;
+    quotient->clear();
+  }
+  if (remainder != nullptr) {
+    remainder->digits_.swap(r);
+    remainder->sign_ = remainder_sign;
+    remainder->clear();
+  }
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger& other) {
+  divMod(*this, other, this, nullptr);
+  return *this;
+}
+
+BigInteger& BigInteger::operator%=(const BigInteger& other) {
+  divMod(*this, other, nullptr, this);
+  return *this;
+}
+
+std::pair<BigInteger, BigInteger> divmod(const BigInteger& a, const BigInteger& b) {
+  std::pair<BigInteger, BigInteger> result;
+  BigInteger::divMod(a, b, &result.first, &result.second);
+  return result;
+}
+
+std::istream& operator>>(std::istream& in, BigInteger& a) {
+  std::string str_in;
+  in >> str_in;
+  a = BigInteger(str_in);
+  return in;
+}
+
+std::ostream& operator<<(std::ostream& out, const BigInteger& a) {
+  char buffer[64];
+  if (a.decimalLength() <= sizeof(buffer)) {
+    out.write(buffer, a.writeDecimal(buffer) - buffer);
+  } else {
+    out << a.toString();
+  }
+  return out;
+}
+
+std::to_chars_result to_chars(char* first, char* last, const BigInteger& value) {
+  if (static_cast<size_t>(last - first) < value.decimalLength()) {
+    return {last, std::errc::value_too_large};
+  }
+  return {value.writeDecimal(first), std::errc()};
+}
+
+// Как std::from_chars: необязательный '-' и хотя бы одна цифра
+std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value) {
+  const char* begin = first;
+  bool sign = true;
+  if (begin != last and *begin == '-') {
+    sign = false;
+    ++begin;
+  }
+  const char* end = begin;
+  while (end != last and *end >= '0' and *end <= '9') {
+    ++end;
+  }
+  if (end == begin) {
+    return {first, std::errc::invalid_argument};
+  }
+  BigInteger::parseLimbs(begin, end, value.digits_);
+  value.sign_ = sign;
+  value.clear();
+  return {end, std::errc()};
+}
+
+BigInteger operator ""_bi(unsigned long long x) {
+  BigInteger tmp = BigInteger(x);
+  return tmp;
+}
+BigInteger operator ""_bi(const char* s) {
+  BigInteger tmp = BigInteger(s);
+  return tmp;
+}
+
+// out = x * u + y * v, где результат заведомо неотрицателен и помещается в size(u) лимбов
+void BigInteger::combineLimbs(const LimbStorage& u, const LimbStorage& v, int64_t x, int64_t y, LimbStorage& out) {
+  out.assign(u.size(), 0);
+  __int128 carry = 0;
+  for (size_t i = 0; i < u.size(); ++i) {
+    carry += static_cast<__int128>(x) * u[i];
+    if (i < v.size()) { carry += static_cast<__int128>(y) * v[i]; }
+    int64_t limb = static_cast<int64_t>(carry % base);
+    carry /= base;
+    if (limb < 0) {
+      limb += base;
+      --carry;
+    }
+    out[i] = limb;
+  }
+}
+
+// Бинарный алгоритм для чисел, помещающихся в машинное слово
+uint64_t BigInteger::binaryGcd(uint64_t a, uint64_t b) {
+  if (a == 0 or b == 0) {
+    return a | b;
+  }
+  int shift = __builtin_ctzll(a | b);
+  a >>= __builtin_ctzll(a);
+  while (b != 0) {
+    b >>= __builtin_ctzll(b);
+    if (a > b) { std::swap(a, b); }
+    b -= a;
+  }
+  return a << shift;
+}
+
+// Алгоритм L Кнута (Лемер): по двум старшим лимбам u и v подбирается матрица
+// частных в машинных словах, и она применяется к длинным числам за один проход.
+// Если coefficient != nullptr, в него пишется x такое, что a * x = gcd (mod b)
+BigInteger BigInteger::gcdLehmer(const BigInteger& a, const BigInteger& b, BigInteger* coefficient) {
+  LimbStorage u = a.digits_;
+  LimbStorage v = b.digits_;
+  BigInteger s_u = 1;
+  BigInteger s_v = 0;
+  if (compareLimbs(u.data(), u.size(), v.data(), v.size()) < 0) {
+    u.swap(v);
+    std::swap(s_u, s_v);
+  }
+  LimbStorage new_u;
+  LimbStorage new_v;
+  while (!(v.size() == 1 and v[0] == 0)) {
+    size_t n = u.size();
+    if (coefficient == nullptr and v.size() <= 2) {
+      BigInteger big_u = fromLimbs(u.data(), u.size());
+      BigInteger big_v = fromLimbs(v.data(), v.size());
+      big_u %= big_v;
+      uint64_t small_u = (big_u.digits_.size() == 2 ? big_u.digits_[1] * base : 0) + big_u.digits_[0];
+      uint64_t small_v = (v.size() == 2 ? v[1] * base : 0) + v[0];
+      return BigInteger(static_cast<int64_t>(binaryGcd(small_u, small_v)));
+    }
+
+    int64_t x_hat = (n == 1 ? u[0] : u[n - 1] * base + u[n - 2]);
+    int64_t y_hat = 0;
+    if (v.size() == n) {
+      y_hat = (n == 1 ? v[0] : v[n - 1] * base + v[n - 2]);
+    } else if (v.size() == n - 1) {
+      y_hat = v[n - 2];
+    }
+    int64_t x_a = 1, x_b = 0, y_a = 0, y_b = 1;
+    while (y_hat + y_a != 0 and y_hat + y_b != 0) {
+      int64_t q = (x_hat + x_a) / (y_hat + y_a);
+      if (q != (x_hat + x_b) / (y_hat + y_b)) { break; }
+      int64_t t = x_a - q * y_a;
+      x_a = y_a;
+      y_a = t;
+      t = x_b - q * y_b;
+      x_b = y_b;
+      y_b = t;
+      t = x_hat - q * y_hat;
+      x_hat = y_hat;
+      y_hat = t;
+    }
+
+    if (x_b == 0) {
+      BigInteger big_u = fromLimbs(u.data(), u.size());
+      BigInteger big_v = fromLimbs(v.data(), v.size());
+      BigInteger q;
+      divMod(big_u, big_v, &q, &big_u);
+      u.swap(v);
+      v.swap(big_u.digits_);
+      if (coefficient != nullptr) {
+        s_u -= q * s_v;
+        std::swap(s_u, s_v);
+      }
+    } else {
+      combineLimbs(u, v, x_a, x_b, new_u);
+      combineLimbs(u, v, y_a, y_b, new_v);
+      u.swap(new_u);
+      v.swap(new_v);
+      trimLimbs(u);
+      trimLimbs(v);
+      if (coefficient != nullptr) {
+        BigInteger new_s_u = s_u * x_a + s_v * x_b;
+        s_v = s_u * y_a + s_v * y_b;
+        s_u = new_s_u;
+      }
+    }
+  }
+  if (coefficient != nullptr) {
+    *coefficient = s_u;
+  }
+  return fromLimbs(u.data(), u.size());
+}
+
+BigInteger gcd(const BigInteger& a, const BigInteger& b) {
+  return BigInteger::gcdLehmer(a, b, nullptr);
+}
+
+// Возвращает g = gcd(a, b) >= 0 и коэффициенты Безу: a * x + b * y = g
+BigInteger extendedGcd(const BigInteger& a, const BigInteger& b, BigInteger& x, BigInteger& y) {
+  BigInteger g = BigInteger::gcdLehmer(a, b, &x);
+  if (a < 0) { x = -x; }
+  if (b == 0) {
+    y = 0;
+  } else {
+    y = (g - a * x) / b;
+  }
+  return g;
+}
+
+// base^exponent бинарным возведением слева направо над буферами лимбов, 0^0 = 1
+BigInteger pow(const BigInteger& base, uint64_t exponent) {
+  BigInteger result = 1;
+  if (exponent == 0) {
+    return result;
+  }
+  LimbStorage& power = result.digits_;
+  power = base.digits_;
+  LimbStorage buffer;
+  for (int bit = 62 - __builtin_clzll(exponent); bit >= 0; --bit) {
+    buffer.assign(2 * power.size(), 0);
+    BigInteger::sqrLimbs(power.data(), power.size(), buffer.data());
+    BigInteger::trimLimbs(buffer);
+    power.swap(buffer);
+    if ((exponent >> bit) & 1) {
+      buffer.assign(power.size() + base.digits_.size(), 0);
+      BigInteger::mulLimbs(power.data(), power.size(), base.digits_.data(), base.digits_.size(), buffer.data());
+      BigInteger::trimLimbs(buffer);
+      power.swap(buffer);
+    }
+  }
+  result.sign_ = base.sign_ or exponent % 2 == 0;
+  result.clear();
+  return result;
+}
+
+// floor(sqrt(n)) для n >= 0. Корень из старшей половины лимбов даёт оценку сверху
+// с половиной верных лимбов, после чего хватает одного-двух шагов Ньютона
+BigInteger isqrt(const BigInteger& n) {
+  assert(n.sign_ and "isqrt: negative argument");
+  size_t len = n.digits_.size();
+  if (len <= 2) {
+    uint64_t value = n.digits_[0] + (len == 2 ? n.digits_[1] * BigInteger::base : 0);
+    uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+    while (root * root > value) { --root; }
+    while ((root + 1) * (root + 1) <= value) { ++root; }
+    return static_cast<int64_t>(root);
+  }
+  size_t k = std::max<size_t>(1, len / 4);
+  BigInteger x = isqrt(BigInteger::fromLimbs(n.digits_.data() + 2 * k, len - 2 * k));
+  ++x;
+  x.shiftLeft(k);
+  // Убывающая последовательность Ньютона от оценки сверху останавливается на floor(sqrt(n))
+  while (true) {
+    BigInteger next;
+    BigInteger::divMod(n, x, &next, nullptr);
+    next += x;
+    next.divSmall(2);
+    if (next >= x) {
+      return x;
+    }
+    x = std::move(next);
+  }
+}
+
+// Целая часть корня степени k >= 1 (для отрицательного n и нечётного k - с округлением к нулю).
+// Как в isqrt, оценка сверху берётся из корня старшей половины лимбов, для коротких n - из double
+BigInteger iroot(const BigInteger& n, uint64_t k) {
+  assert(k >= 1 and "iroot: root degree must be positive");
+  if (!n.sign_) {
+    assert(k % 2 == 1 and "iroot: even root of a negative number");
+    return -iroot(-n, k);
+  }
+  if (k == 1 or n < 2) {
+    return n;
+  }
+  if (k == 2) {
+    return isqrt(n);
+  }
+  size_t len = n.digits_.size();
+  // Каждый лимб меньше 2^30, поэтому при k >= 30 * len корень равен 1
+  if (k >= 30 * len) {
+    return 1;
+  }
+  BigInteger x;
+  size_t shift = len / (2 * k);
+  if (shift > 0) {
+    x = iroot(BigInteger::fromLimbs(n.digits_.data() + k * shift, len - k * shift), k);
+    ++x;
+    x.shiftLeft(shift);
+  } else {
+    double top = static_cast<double>(n.digits_[len - 1]) + (len >= 2 ? n.digits_[len - 2] / 1e9 : 0.0);
+    double root_log = (std::log10(top) + 9.0 * static_cast<double>(len - 1)) / static_cast<double>(k);
+    int64_t exponent = std::max<int64_t>(0, static_cast<int64_t>(root_log) - 15);
+    x = static_cast<int64_t>(std::pow(10.0, root_log - exponent) * (1 + 1e-9)) + 1;
+    if (exponent > 0) {
+      x *= pow(BigInteger(10), static_cast<uint64_t>(exponent));
+    }
+  }
+  BigInteger degree = static_cast<int64_t>(k);
+  BigInteger previous = static_cast<int64_t>(k - 1);
+  // Первый шаг делается всегда: из любого x > 0 он приводит к оценке не меньше ответа
+  bool first = true;
+  while (true) {
+    BigInteger next;
+    BigInteger::divMod(n, pow(x, k - 1), &next, nullptr);
+    addmul(next, previous, x);
+    next /= degree;
+    if (!first and next >= x) {
+      return x;
+    }
+    first = false;
+    x = std::move(next);
+  }
+}
+
+// Пакет чисел в раскладке "структура массивов": k-й лимб i-го числа лежит в limbs_[k * size_ + i].
+// Операции идут по лимбам сразу для всех чисел пакета; внутренний цикл - по числам, итерации
+// независимы и векторизуются компилятором. Буфер результата переиспользуется между вызовами.
+// Буферы берутся из ресурса LimbResourceScope на момент создания пакета, как у LimbStorage
+class BigIntegerBatch {
+ public:
+
+  BigIntegerBatch() = default;
+
+  // Копия - в текущем ресурсе; перемещение забирает буферы вместе с ресурсом
+  BigIntegerBatch(const BigIntegerBatch& other)
+      : size_(other.size_), width_(other.width_), limbs_(other.limbs_, LimbResourceScope::current()),
+        signs_(other.signs_, LimbResourceScope::current()) {}
+
+  BigIntegerBatch(BigIntegerBatch&& other) = default;
+  BigIntegerBatch& operator=(const BigIntegerBatch& other) = default;
+  BigIntegerBatch& operator=(BigIntegerBatch&& other) = default;
+
+  BigIntegerBatch(const BigInteger* values, size_t count) {
+    assign(values, count);
+  }
+
+  void assign(const BigInteger* values, size_t count) {
+    size_t width = 1;
+    for (size_t i = 0; i < count; ++i) {
+      width = std::max(width, values[i].digits_.size());
+    }
+    reset(count, width);
+    for (size_t i = 0; i < count; ++i) {
+      const LimbStorage& digits = values[i].digits_;
+      for (size_t k = 0; k < digits.size(); ++k) {
+        limbs_[k * size_ + i] = digits[k];
+      }
+      signs_[i] = (values[i].sign_ ? 1 : -1);
+    }
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  // Число лимбов самого длинного числа пакета
+  size_t width() const {
+    return width_;
+  }
+
+  BigInteger operator[](size_t index) const {
+    BigInteger result;
+    result.digits_.resize(width_);
+    for (size_t k = 0; k < width_; ++k) {
+      result.digits_[k] = limbs_[k * size_ + index];
+    }
+    result.sign_ = (signs_[index] > 0);
+    result.clear();
+    return result;
+  }
+
+  void unpack(BigInteger* out) const {
+    for (size_t i = 0; i < size_; ++i) {
+      out[i] = (*this)[i];
+    }
+  }
+
+  // out[i] = a[i] + b[i]; пакеты одного размера
+  static void add(const BigIntegerBatch& a, const BigIntegerBatch& b, BigIntegerBatch& out) {
+    addSigned(a, b, 1, out);
+  }
+
+  static void sub(const BigIntegerBatch& a, const BigIntegerBatch& b, BigIntegerBatch& out) {
+    addSigned(a, b, -1, out);
+  }
+
+  // out[i] = a[i] * b[i] школьным умножением. Если в столбце не больше kColumnTerms произведений,
+  // столбец суммируется в uint64_t без переносов и делится на base один раз
+  static void mul(const BigIntegerBatch& a, const BigIntegerBatch& b, BigIntegerBatch& out) {
+    assert(a.size_ == b.size_ and "BigIntegerBatch: batches of different size");
+    if (&out == &a or &out == &b) {
+      BigIntegerBatch result(out.limbs_.get_allocator().resource());
+      mul(a, b, result);
+      out.swap(result);
+      return;
+    }
+    size_t n = a.size_;
+    out.reset(n, a.width_ + b.width_);
+    for (size_t l = 0; l < n; ++l) {
+      out.signs_[l] = a.signs_[l] * b.signs_[l];
+    }
+    if (std::min(a.width_, b.width_) <= kColumnTerms) {
+      mulColumns(a, b, out);
+      return;
+    }
+    for (size_t first = 0; first < n; first += kBlock) {
+      size_t count = std::min(kBlock, n - first);
+      int64_t carry[kBlock];
+      for (size_t i = 0; i < a.width_; ++i) {
+        const int64_t* row_a = &a.limbs_[i * n + first];
+        std::fill(carry, carry + count, 0);
+        for (size_t j = 0; j < b.width_; ++j) {
+          const int64_t* row_b = &b.limbs_[j * n + first];
+          int64_t* row_out = &out.limbs_[(i + j) * n + first];
+          for (size_t l = 0; l < count; ++l) {
+            int64_t tmp = row_out[l] + row_a[l] * row_b[l] + carry[l];
+            carry[l] = tmp / BigInteger::base;
+            row_out[l] = tmp - carry[l] * BigInteger::base;
+          }
+        }
+        std::copy(carry, carry + count, &out.limbs_[(i + b.width_) * n + first]);
+      }
+    }
+  }
+
+  // При разных ресурсах std::swap копирует элементы, и каждый пакет остаётся в своём ресурсе
+  void swap(BigIntegerBatch& other) {
+    std::swap(size_, other.size_);
+    std::swap(width_, other.width_);
+    std::swap(limbs_, other.limbs_);
+    std::swap(signs_, other.signs_);
+  }
+
+ private:
+  // Числа обрабатываются блоками, чтобы строки лимбов блока оставались в кэше L1
+  static constexpr size_t kBlock = 256;
+  // 18 * (base - 1)^2 плюс перенос из предыдущего столбца ещё меньше 2^64
+  static constexpr size_t kColumnTerms = 18;
+
+  // Временный пакет в ресурсе out: обмен с ним не копирует буферы
+  explicit BigIntegerBatch(std::pmr::memory_resource* resource) : limbs_(resource), signs_(resource) {}
+
+  static void mulColumns(const BigIntegerBatch& a, const BigIntegerBatch& b, BigIntegerBatch& out) {
+    size_t n = a.size_;
+    const uint64_t base = static_cast<uint64_t>(BigInteger::base);
+    for (size_t first = 0; first < n; first += kBlock) {
+      size_t count = std::min(kBlock, n - first);
+      uint64_t sum[kBlock] = {};
+      for (size_t column = 0; column < out.width_; ++column) {
+        size_t low = (column + 1 > b.width_ ? column + 1 - b.width_ : 0);
+        size_t high = std::min(column + 1, a.width_);
+        for (size_t i = low; i < high; ++i) {
+          const int64_t* row_a = &a.limbs_[i * n + first];
+          const int64_t* row_b = &b.limbs_[(column - i) * n + first];
+          for (size_t l = 0; l < count; ++l) {
+            sum[l] += static_cast<uint64_t>(row_a[l]) * static_cast<uint64_t>(row_b[l]);
+          }
+        }
+        int64_t* row_out = &out.limbs_[column * n + first];
+        for (size_t l = 0; l < count; ++l) {
+          uint64_t carry = sum[l] / base;
+          row_out[l] = static_cast<int64_t>(sum[l] - carry * base);
+          sum[l] = carry;
+        }
+      }
+    }
+  }
+
+  size_t size_ = 0;
+  size_t width_ = 0;
+  ScratchVector<int64_t> limbs_{LimbResourceScope::current()};
+  // +1 или -1, чтобы знак участвовал в арифметике без ветвлений
+  ScratchVector<int64_t> signs_{LimbResourceScope::current()};
+
+  // Размеры меняются без освобождения памяти: vector сохраняет ёмкость
+  void reset(size_t count, size_t width) {
+    size_ = count;
+    width_ = width;
+    limbs_.assign(count * width, 0);
+    signs_.assign(count, 1);
+  }
+
+  // Цифры со знаком: t = |a|_k +- |b|_k + перенос. При равных знаках перенос 0 или 1, при разных
+  // 0 или -1; итоговый перенос -1 значит |a| < |b|, тогда второй проход берёт дополнение до base^width
+  static void addSigned(const BigIntegerBatch& a, const BigIntegerBatch& b, int64_t b_sign, BigIntegerBatch& out) {
+    assert(a.size_ == b.size_ and "BigIntegerBatch: batches of different size");
+    if (&out == &a or &out == &b) {
+      BigIntegerBatch result(out.limbs_.get_allocator().resource());
+      addSigned(a, b, b_sign, result);
+      out.swap(result);
+      return;
+    }
+    size_t n = a.size_;
+    size_t width = std::max(a.width_, b.width_);
+    out.reset(n, width + 1);
+    static const int64_t zeros[kBlock] = {};
+    for (size_t first = 0; first < n; first += kBlock) {
+      size_t count = std::min(kBlock, n - first);
+      int64_t factor[kBlock];
+      int64_t carry[kBlock] = {};
+      for (size_t l = 0; l < count; ++l) {
+        factor[l] = a.signs_[first + l] * b.signs_[first + l] * b_sign;
+      }
+      for (size_t k = 0; k < width; ++k) {
+        const int64_t* row_a = (k < a.width_ ? &a.limbs_[k * n + first] : zeros);
+        const int64_t* row_b = (k < b.width_ ? &b.limbs_[k * n + first] : zeros);
+        int64_t* row_out = &out.limbs_[k * n + first];
+        for (size_t l = 0; l < count; ++l) {
+          int64_t tmp = row_a[l] + factor[l] * row_b[l] + carry[l];
+          carry[l] = static_cast<int64_t>(tmp >= BigInteger::base) - static_cast<int64_t>(tmp < 0);
+          row_out[l] = tmp - carry[l] * BigInteger::base;
+        }
+      }
+      // Для отрицательных разностей factor = -1: цифры заменяются на base^width - D
+      bool any_negative = false;
+      for (size_t l = 0; l < count; ++l) {
+        factor[l] = (carry[l] < 0 ? -1 : 1);
+        any_negative |= (carry[l] < 0);
+        out.limbs_[width * n + first + l] = (carry[l] > 0 ? 1 : 0);
+        out.signs_[first + l] = a.signs_[first + l] * factor[l];
+        carry[l] = 0;
+      }
+      for (size_t k = 0; any_negative and k < width; ++k) {
+        int64_t* row_out = &out.limbs_[k * n + first];
+        for (size_t l = 0; l < count; ++l) {
+          int64_t tmp = factor[l] * row_out[l] + carry[l];
+          carry[l] = -static_cast<int64_t>(tmp < 0);
+          row_out[l] = tmp - carry[l] * BigInteger::base;
+        }
+      }
+    }
+  }
+};
+
+// Альтернативное представление: лимбы по основанию 2^64, переносы через unsigned __int128.
+// В десятичную систему число переводится только на вводе-выводе, через BigInteger
+class BinaryBigInteger {
+ public:
+
+  BinaryBigInteger() : sign_(true) {}
+
+  BinaryBigInteger(const int64_t& a) : sign_(a >= 0) {
+    uint64_t magnitude = (a >= 0 ? static_cast<uint64_t>(a) : 0 - static_cast<uint64_t>(a));
+    if (magnitude != 0) { limbs_.push_back(magnitude); }
+  }
+
+  explicit BinaryBigInteger(const BigInteger& a);
+
+  explicit BinaryBigInteger(const std::string& s) : BinaryBigInteger(BigInteger(s)) {}
+
+  BigInteger toBigInteger() const;
+
+  std::string toString() const {
+    return toBigInteger().toString();
+  }
+
+  explicit operator bool() const {
+    return !limbs_.empty();
+  }
+
+  // Число значащих бит модуля
+  size_t bitLength() const {
+    if (limbs_.empty()) {
+      return 0;
+    }
+    return 64 * limbs_.size() - static_cast<size_t>(__builtin_clzll(limbs_.back()));
+  }
+
+  // Бит модуля с номером index (младший - нулевой)
+  bool bit(size_t index) const {
+    return index / 64 < limbs_.size() and ((limbs_[index / 64] >> (index % 64)) & 1) != 0;
+  }
+
+  // Лимбы модуля по основанию 2^64, младший первый
+  const std::vector<uint64_t>& words() const {
+    return limbs_;
+  }
+
+  // Число из лимбов модуля (младший первый, ведущие нули допустимы) и знака
+  static BinaryBigInteger fromWords(std::vector<uint64_t> words, bool negative) {
+    BinaryBigInteger result;
+    result.limbs_ = std::move(words);
+    while (!result.limbs_.empty() and result.limbs_.back() == 0) {
+      result.limbs_.pop_back();
+    }
+    result.sign_ = !negative or result.limbs_.empty();
+    return result;
+  }
+
+  BinaryBigInteger& operator+() {
+    return *this;
+  }
+
+  BinaryBigInteger operator-() const {
+    BinaryBigInteger copy = *this;
+    if (!copy.limbs_.empty()) {
+      copy.sign_ = !copy.sign_;
+    }
+    return copy;
+  }
+
+  BinaryBigInteger& operator+=(const BinaryBigInteger& other) {
+    addSigned(other, other.sign_);
+    return *this;
+  }
+
+  BinaryBigInteger& operator-=(const BinaryBigInteger& other) {
+    addSigned(other, !other.sign_);
+    return *this;
+  }
+
+  BinaryBigInteger& operator*=(const BinaryBigInteger& other);
+
+  BinaryBigInteger& operator/=(const BinaryBigInteger& other) {
+    divMod(*this, other, this, nullptr);
+    return *this;
+  }
+
+  BinaryBigInteger& operator%=(const BinaryBigInteger& other) {
+    divMod(*this, other, nullptr, this);
+    return *this;
+  }
+
+  BinaryBigInteger& operator++() {
+    *this += 1;
+    return *this;
+  }
+
+  BinaryBigInteger operator++(int) {
+    BinaryBigInteger copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  BinaryBigInteger& operator--() {
+    *this -= 1;
+    return *this;
+  }
+
+  BinaryBigInteger operator--(int) {
+    BinaryBigInteger copy = *this;
+    --*this;
+    return copy;
+  }
+
+  inline static size_t karatsuba_threshold = 32;
+
+ private:
+  bool sign_; // Знак числа, false = -; true = положительное
+  std::vector<uint64_t> limbs_; // Младший лимб первый, без ведущих нулей; ноль - пустой вектор
+
+  friend bool operator<(const BinaryBigInteger& a, const BinaryBigInteger& b);
+  friend bool operator==(const BinaryBigInteger& a, const BinaryBigInteger& b);
+  friend std::pair<BinaryBigInteger, BinaryBigInteger> divmod(const BinaryBigInteger& a, const BinaryBigInteger& b);
+  friend class MontgomeryContext;
+
+  static int compareLimbs(const uint64_t* a, size_t n, const uint64_t* b, size_t m);
+  static uint64_t addLimbs(uint64_t* a, size_t n, const uint64_t* b, size_t m);
+  static uint64_t subLimbs(uint64_t* a, size_t n, const uint64_t* b, size_t m);
+  static void mulLimbs(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* res);
+  static void mulSchoolbook(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* res);
+  static void mulKaratsuba(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* res);
+  static uint64_t divSmallLimbs(uint64_t* a, size_t n, uint64_t divisor);
+  static void divModLimbs(const uint64_t* a, size_t n, const uint64_t* b, size_t m,
+                          std::vector<uint64_t>& quotient, std::vector<uint64_t>& remainder);
+  static void divMod(const BinaryBigInteger& a, const BinaryBigInteger& b,
+                     BinaryBigInteger* quotient, BinaryBigInteger* remainder);
+  static BigInteger toDecimal(const uint64_t* a, size_t n, const std::vector<BigInteger>& powers, size_t level);
+  static BinaryBigInteger fromDecimal(const int64_t* a, size_t n,
+                                      const std::vector<BinaryBigInteger>& powers, size_t level);
+
+  void addSigned(const BinaryBigInteger& other, bool other_sign);
+
+  void clear() {
+    while (!limbs_.empty() and limbs_.back() == 0) {
+      limbs_.pop_back();
+    }
+    if (limbs_.empty()) {
+      sign_ = true;
+    }
+  }
+};
+
+BinaryBigInteger operator+(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  BinaryBigInteger result = a;
+  result += b;
+  return result;
+}
+
+BinaryBigInteger operator-(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  BinaryBigInteger result = a;
+  result -= b;
+  return result;
+}
+
+BinaryBigInteger operator*(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  BinaryBigInteger result = a;
+  result *= b;
+  return result;
+}
+
+BinaryBigInteger operator/(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  BinaryBigInteger result = a;
+  result /= b;
+  return result;
+}
+
+BinaryBigInteger operator%(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  BinaryBigInteger result = a;
+  result %= b;
+  return result;
+}
+
+bool operator<(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  if (a.sign_ != b.sign_) {
+    return !a.sign_;
+  }
+  int cmp = BinaryBigInteger::compareLimbs(a.limbs_.data(), a.limbs_.size(), b.limbs_.data(), b.limbs_.size());
+  return (a.sign_ ? cmp < 0 : cmp > 0);
+}
+
+bool operator==(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  return a.sign_ == b.sign_ and a.limbs_ == b.limbs_;
+}
+
+bool operator!=(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  return !(a == b);
+}
+
+bool operator>(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  return b < a;
+}
+
+bool operator<=(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  return !(b < a);
+}
+
+bool operator>=(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  return !(a < b);
+}
+
+int BinaryBigInteger::compareLimbs(const uint64_t* a, size_t n, const uint64_t* b, size_t m) {
+  while (n > 0 and a[n - 1] == 0) { --n; }
+  while (m > 0 and b[m - 1] == 0) { --m; }
+  if (n != m) {
+    return (n < m ? -1 : 1);
+  }
+  for (size_t j = n; j-- > 0;) {
+    if (a[j] != b[j]) {
+      return (a[j] < b[j] ? -1 : 1);
+    }
+  }
+  return 0;
+}
+
+// a[0..n) += b[0..m), n >= m; возвращает перенос
+uint64_t BinaryBigInteger::addLimbs(uint64_t* a, size_t n, const uint64_t* b, size_t m) {
+  unsigned __int128 carry = 0;
+  size_t i = 0;
+  for (; i < m; ++i) {
+    carry += static_cast<unsigned __int128>(a[i]) + b[i];
+    a[i] = static_cast<uint64_t>(carry);
+    carry >>= 64;
+  }
+  for (; carry != 0 and i < n; ++i) {
+    a[i] += 1;
+    carry = (a[i] == 0);
+  }
+  return static_cast<uint64_t>(carry);
+}
+
+// a[0..n) -= b[0..m), n >= m; возвращает заём
+uint64_t BinaryBigInteger::subLimbs(uint64_t* a, size_t n, const uint64_t* b, size_t m) {
+  uint64_t borrow = 0;
+  size_t i = 0;
+  for (; i < m; ++i) {
+    uint64_t subtrahend = b[i] + borrow;
+    uint64_t next_borrow = (subtrahend < borrow) | (a[i] < subtrahend);
+    a[i] -= subtrahend;
+    borrow = next_borrow;
+  }
+  for (; borrow != 0 and i < n; ++i) {
+    borrow = (a[i] == 0);
+    a[i] -= 1;
+  }
+  return borrow;
+}
+
+void BinaryBigInteger::mulSchoolbook(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* res) {
+  for (size_t i = 0; i < n; ++i) {
+    unsigned __int128 carry = 0;
+    for (size_t j = 0; j < m; ++j) {
+      carry += static_cast<unsigned __int128>(a[i]) * b[j] + res[i + j];
+      res[i + j] = static_cast<uint64_t>(carry);
+      carry >>= 64;
+    }
+    res[i + m] = static_cast<uint64_t>(carry);
+  }
+}
+
+// res[0..n+m) должен быть обнулён
+void BinaryBigInteger::mulLimbs(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* res) {
+  while (n > 0 and a[n - 1] == 0) { --n; }
+  while (m > 0 and b[m - 1] == 0) { --m; }
+  if (n < m) {
+    std::swap(a, b);
+    std::swap(n, m);
+  }
+  if (m == 0) {
+    return;
+  }
+  if (m < karatsuba_threshold) {
+    mulSchoolbook(a, n, b, m, res);
+  } else if (2 * m <= n + 1) {
+    std::vector<uint64_t> part(2 * m);
+    for (size_t i = 0; i < n; i += m) {
+      size_t len = std::min(m, n - i);
+      std::fill(part.begin(), part.end(), 0);
+      mulLimbs(a + i, len, b, m, part.data());
+      addLimbs(res + i, n + m - i, part.data(), len + m);
+    }
+  } else {
+    mulKaratsuba(a, n, b, m, res);
+  }
+}
+
+// n >= m > (n + 1) / 2
+void BinaryBigInteger::mulKaratsuba(const uint64_t* a, size_t n, const uint64_t* b, size_t m, uint64_t* res) {
+  size_t h = (n + 1) / 2;
+  mulLimbs(a, h, b, h, res);
+  mulLimbs(a + h, n - h, b + h, m - h, res + 2 * h);
+
+  std::vector<uint64_t> sum_a(a, a + h);
+  sum_a.push_back(addLimbs(sum_a.data(), h, a + h, n - h));
+  std::vector<uint64_t> sum_b(b, b + h);
+  sum_b.push_back(addLimbs(sum_b.data(), h, b + h, m - h));
+
+  std::vector<uint64_t> middle(2 * h + 2, 0);
+  mulLimbs(sum_a.data(), h + 1, sum_b.data(), h + 1, middle.data());
+  subLimbs(middle.data(), middle.size(), res, 2 * h);
+  subLimbs(middle.data(), middle.size(), res + 2 * h, n + m - 2 * h);
+  size_t len = middle.size();
+  while (len > 0 and middle[len - 1] == 0) { --len; }
+  addLimbs(res + h, n + m - h, middle.data(), len);
+}
+
+uint64_t BinaryBigInteger::divSmallLimbs(uint64_t* a, size_t n, uint64_t divisor) {
+  unsigned __int128 remainder = 0;
+  for (size_t j = n; j-- > 0;) {
+    remainder = (remainder << 64) | a[j];
+    a[j] = static_cast<uint64_t>(remainder / divisor);
+    remainder %= divisor;
+  }
+  return static_cast<uint64_t>(remainder);
+}
+
+// Алгоритм D Кнута по основанию 2^64: n >= m >= 2, b[m - 1] != 0
+void BinaryBigInteger::divModLimbs(const uint64_t* a, size_t n, const uint64_t* b, size_t m,
+                                   std::vector<uint64_t>& quotient, std::vector<uint64_t>& remainder) {
+  int shift = __builtin_clzll(b[m - 1]);
+  std::vector<uint64_t> u(n + 1, 0);
+  std::vector<uint64_t> v(m, 0);
+  for (size_t i = m; i-- > 0;) {
+    v[i] = (b[i] << shift) | (shift != 0 and i > 0 ? b[i - 1] >> (64 - shift) : 0);
+  }
+  u[n] = (shift != 0 ? a[n - 1] >> (64 - shift) : 0);
+  for (size_t i = n; i-- > 0;) {
+    u[i] = (a[i] << shift) | (shift != 0 and i > 0 ? a[i - 1] >> (64 - shift) : 0);
+  }
+
+  const unsigned __int128 kBase = static_cast<unsigned __int128>(1) << 64;
+  quotient.assign(n - m + 1, 0);
+  for (size_t j = n - m + 1; j-- > 0;) {
+    unsigned __int128 top = (static_cast<unsigned __int128>(u[j + m]) << 64) | u[j + m - 1];
+    unsigned __int128 q_hat = top / v[m - 1];
+    unsigned __int128 r_hat = top % v[m - 1];
+    while (q_hat >= kBase or q_hat * v[m - 2] > ((r_hat << 64) | u[j + m - 2])) {
+      --q_hat;
+      r_hat += v[m - 1];
+      if (r_hat >= kBase) { break; }
+    }
+
+    uint64_t borrow = 0;
+    uint64_t carry = 0;
+    for (size_t i = 0; i < m; ++i) {
+      unsigned __int128 product = q_hat * v[i] + carry;
+      carry = static_cast<uint64_t>(product >> 64);
+      uint64_t low = static_cast<uint64_t>(product);
+      uint64_t subtrahend = low + borrow;
+      uint64_t next_borrow = (subtrahend < borrow) | (u[i + j] < subtrahend);
+      u[i + j] -= subtrahend;
+      borrow = next_borrow;
+    }
+    unsigned __int128 top_subtrahend = static_cast<unsigned __int128>(carry) + borrow;
+    bool negative = (u[j + m] < top_subtrahend);
+    u[j + m] -= static_cast<uint64_t>(top_subtrahend);
+    if (negative) {
+      // q_hat оказалось на единицу больше: возвращаем делитель обратно
+      --q_hat;
+      u[j + m] += addLimbs(u.data() + j, m, v.data(), m);
+    }
+    quotient[j] = static_cast<uint64_t>(q_hat);
+  }
+
+  remainder.assign(m, 0);
+  for (size_t i = 0; i < m; ++i) {
+    remainder[i] = (u[i] >> shift) | (shift != 0 ? u[i + 1] << (64 - shift) : 0);
+  }
+}
+
+void BinaryBigInteger::divMod(const BinaryBigInteger& a, const BinaryBigInteger& b,
+                              BinaryBigInteger* quotient, BinaryBigInteger* remainder) {
+  bool quotient_sign = !(a.sign_ xor b.sign_);
+  bool remainder_sign = a.sign_;
+  std::vector<uint64_t> q;
+  std::vector<uint64_t> r;
+  size_t n = a.limbs_.size();
+  size_t m = b.limbs_.size();
+  if (compareLimbs(a.limbs_.data(), n, b.limbs_.data(), m) < 0) {
+    r = a.limbs_;
+  } else if (m == 1) {
+    q = a.limbs_;
+    r.assign(1, divSmallLimbs(q.data(), n, b.limbs_[0]));
+  } else {
+    divModLimbs(a.limbs_.data(), n, b.limbs_.data(), m, q, r);
+  }
+  if (quotient != nullptr) {
+    quotient->limbs_.swap(q);
+    quotient->sign_ = quotient_sign;
+    quotient->clear();
+  }
+  if (remainder != nullptr) {
+    remainder->limbs_.swap(r);
+    remainder->sign_ = remainder_sign;
+    remainder->clear();
+  }
+}
+
+std::pair<BinaryBigInteger, BinaryBigInteger> divmod(const BinaryBigInteger& a, const BinaryBigInteger& b) {
+  std::pair<BinaryBigInteger, BinaryBigInteger> result;
+  BinaryBigInteger::divMod(a, b, &result.first, &result.second);
+  return result;
+}
+
+void BinaryBigInteger::addSigned(const BinaryBigInteger& other, bool other_sign) {
+  size_t n = limbs_.size();
+  size_t m = other.limbs_.size();
+  if (sign_ == other_sign or n == 0) {
+    sign_ = (n == 0 ? other_sign : sign_);
+    if (n < m) { limbs_.resize(m, 0); }
+    uint64_t carry = addLimbs(limbs_.data(), limbs_.size(), other.limbs_.data(), m);
+    if (carry != 0) { limbs_.push_back(carry); }
+  } else if (compareLimbs(limbs_.data(), n, other.limbs_.data(), m) >= 0) {
+    subLimbs(limbs_.data(), n, other.limbs_.data(), m);
+  } else {
+    std::vector<uint64_t> result = other.limbs_;
+    subLimbs(result.data(), m, limbs_.data(), n);
+    limbs_.swap(result);
+    sign_ = other_sign;
+  }
+  clear();
+}
+
+BinaryBigInteger& BinaryBigInteger::operator*=(const BinaryBigInteger& other) {
+  std::vector<uint64_t> result(limbs_.size() + other.limbs_.size(), 0);
+  mulLimbs(limbs_.data(), limbs_.size(), other.limbs_.data(), other.limbs_.size(), result.data());
+  limbs_.swap(result);
+  sign_ = !(sign_ xor other.sign_);
+  clear();
+  return *this;
+}
+
+// Разделяй и властвуй: x = hi * 2^(64 * 2^(level - 1)) + lo, степени посчитаны заранее.
+// Умножения идут в BigInteger (Карацуба / Тоом-3 / NTT), поэтому перевод субквадратичный
+BigInteger BinaryBigInteger::toDecimal(const uint64_t* a, size_t n, const std::vector<BigInteger>& powers,
+                                       size_t level) {
+  if (level == 0) {
+    BigInteger result;
+    result.digits_.assign({static_cast<int64_t>(a[0] % BigInteger::base),
+                           static_cast<int64_t>(a[0] / BigInteger::base % BigInteger::base),
+                           static_cast<int64_t>(a[0] / BigInteger::base / BigInteger::base)});
+    result.clear();
+    return result;
+  }
+  size_t half = size_t(1) << (level - 1);
+  if (n <= half) {
+    return toDecimal(a, n, powers, level - 1);
+  }
+  BigInteger result = toDecimal(a + half, n - half, powers, level - 1);
+  result *= powers[level - 1];
+  result += toDecimal(a, half, powers, level - 1);
+  return result;
+}
+
+BinaryBigInteger BinaryBigInteger::fromDecimal(const int64_t* a, size_t n,
+                                               const std::vector<BinaryBigInteger>& powers, size_t level) {
+  if (level == 0) {
+    return BinaryBigInteger(a[0]);
+  }
+  size_t half = size_t(1) << (level - 1);
+  if (n <= half) {
+    return fromDecimal(a, n, powers, level - 1);
+  }
+  BinaryBigInteger result = fromDecimal(a + half, n - half, powers, level - 1);
+  result *= powers[level - 1];
+  result += fromDecimal(a, half, powers, level - 1);
+  return result;
+}
+
+BigInteger BinaryBigInteger::toBigInteger() const {
+  if (limbs_.empty()) {
+    return BigInteger(0);
+  }
+  // powers[k] = 2^(64 * 2^k)
+  std::vector<BigInteger> powers;
+  uint64_t max_word = ~uint64_t(0);
+  powers.push_back(toDecimal(&max_word, 1, powers, 0) + 1);
+  size_t level = 0;
+  for (; (size_t(1) << level) < limbs_.size(); ++level) {
+    if (level > 0) {
+      BigInteger next = powers.back();
+      next.square();
+      powers.push_back(next);
+    }
+  }
+  BigInteger result = toDecimal(limbs_.data(), limbs_.size(), powers, level);
+  return (sign_ ? result : -result);
+}
+
+BinaryBigInteger::BinaryBigInteger(const BigInteger& a) : sign_(true) {
+  // powers[k] = 10^(9 * 2^k)
+  std::vector<BinaryBigInteger> powers(1, BinaryBigInteger(BigInteger::base));
+  size_t level = 0;
+  for (; (size_t(1) << level) < a.digits_.size(); ++level) {
+    if (level > 0) {
+      powers.push_back(powers.back() * powers.back());
+    }
+  }
+  *this = fromDecimal(a.digits_.data(), a.digits_.size(), powers, level);
+  if (!a.sign_ and !limbs_.empty()) {
+    sign_ = false;
+  }
+}
+
+std::ostream& operator<<(std::ostream& out, const BinaryBigInteger& a) {
+  out << a.toBigInteger();
   return out;
 }
 
-BigInteger operator ""_bi(unsigned long long x) {
-  BigInteger tmp = BigInteger(x);
-  return tmp;
-}
-BigInteger operator ""_bi(const char* s) {
-  BigInteger tmp = BigInteger(s);
-  return tmp;
-}
+std::istream& operator>>(std::istream& in, BinaryBigInteger& a) {
+  BigInteger decimal;
+  in >> decimal;
+  a = BinaryBigInteger(decimal);
+  return in;
+}
+
+// Скользящее окно: степень exponent >= 0, mul(x, y) - умножение в нужном кольце, one - единица кольца
+template <typename T, typename Multiply>
+T slidingWindowPow(const T& base, const BinaryBigInteger& exponent, const T& one, Multiply mul) {
+  size_t bits = exponent.bitLength();
+  if (bits == 0) {
+    return one;
+  }
+  size_t window = (bits <= 24 ? 1 : bits <= 80 ? 3 : bits <= 240 ? 4 : bits <= 672 ? 5 : 6);
+  // table[k] = base^(2k + 1)
+  std::vector<T> table(size_t(1) << (window - 1), base);
+  T square = mul(base, base);
+  for (size_t k = 1; k < table.size(); ++k) {
+    table[k] = mul(table[k - 1], square);
+  }
+  T result = one;
+  bool started = false;
+  for (size_t i = bits; i-- > 0;) {
+    if (!exponent.bit(i)) {
+      if (started) { result = mul(result, result); }
+      continue;
+    }
+    size_t low = (i + 1 >= window ? i + 1 - window : 0);
+    while (!exponent.bit(low)) { ++low; }
+    size_t value = 0;
+    for (size_t j = i + 1; j-- > low;) {
+      value = (value << 1) | static_cast<size_t>(exponent.bit(j));
+      if (started) { result = mul(result, result); }
+    }
+    result = (started ? mul(result, table[value >> 1]) : table[value >> 1]);
+    started = true;
+    i = low;
+  }
+  return result;
+}
+
+// Умножение по Монтгомери для фиксированного нечётного модуля m > 1 в словах по 2^64:
+// числа хранятся как x * R mod m, R = 2^(64 s), редукция REDC без делений
+class MontgomeryContext {
+ public:
+
+  explicit MontgomeryContext(const BigInteger& mod) : modulus_(mod) {
+    words_ = BinaryBigInteger(mod).limbs_;
+    size_t s = words_.size();
+    uint64_t inverse = words_[0];
+    for (int i = 0; i < 5; ++i) {
+      inverse *= 2 - words_[0] * inverse;
+    }
+    inv_ = 0 - inverse;
+    BinaryBigInteger r = 1;
+    r.limbs_.assign(s + 1, 0);
+    r.limbs_[s] = 1;
+    BigInteger r_mod = r.toBigInteger() % mod;
+    one_ = toWords(r_mod);
+    r2_ = toWords(r_mod * r_mod % mod);
+  }
+
+  const BigInteger& modulus() const {
+    return modulus_;
+  }
+
+  // a * b mod m для обычных (не монтгомеровских) a и b
+  BigInteger multiply(const BigInteger& a, const BigInteger& b) const {
+    std::vector<uint64_t> x = toMontgomery(a);
+    std::vector<uint64_t> y = toMontgomery(b);
+    std::vector<uint64_t> result(words_.size());
+    montgomeryMultiply(x.data(), y.data(), result.data());
+    return fromMontgomery(result);
+  }
+
+  // base^exponent mod m, exponent >= 0
+  BigInteger pow(const BigInteger& base, const BigInteger& exponent) const {
+    std::vector<uint64_t> result(words_.size());
+    auto mul = [this, &result](const std::vector<uint64_t>& x, const std::vector<uint64_t>& y) {
+      montgomeryMultiply(x.data(), y.data(), result.data());
+      return result;
+    };
+    return fromMontgomery(slidingWindowPow(toMontgomery(base), BinaryBigInteger(exponent), one_, mul));
+  }
+
+ private:
+  BigInteger modulus_;
+  std::vector<uint64_t> words_; // Модуль, s слов
+  uint64_t inv_; // -m^(-1) mod 2^64
+  std::vector<uint64_t> one_; // R mod m
+  std::vector<uint64_t> r2_; // R^2 mod m
+
+  // Приведение x в [0, m) и запись в s слов
+  std::vector<uint64_t> toWords(const BigInteger& x) const {
+    BigInteger reduced = x % modulus_;
+    if (reduced < 0) { reduced += modulus_; }
+    std::vector<uint64_t> result = BinaryBigInteger(reduced).limbs_;
+    result.resize(std::max(words_.size(), size_t(1)), 0);
+    return result;
+  }
+
+  std::vector<uint64_t> toMontgomery(const BigInteger& x) const {
+    std::vector<uint64_t> words = toWords(x);
+    std::vector<uint64_t> result(words_.size());
+    montgomeryMultiply(words.data(), r2_.data(), result.data());
+    return result;
+  }
+
+  BigInteger fromMontgomery(const std::vector<uint64_t>& x) const {
+    std::vector<uint64_t> unit(words_.size(), 0);
+    unit[0] = 1;
+    BinaryBigInteger result;
+    result.limbs_.resize(words_.size());
+    montgomeryMultiply(x.data(), unit.data(), result.limbs_.data());
+    result.clear();
+    return result.toBigInteger();
+  }
+
+  // out = a * b * R^(-1) mod m, схема CIOS; out может совпадать с a или b
+  void montgomeryMultiply(const uint64_t* a, const uint64_t* b, uint64_t* out) const {
+    size_t s = words_.size();
+    const uint64_t* n = words_.data();
+    uint64_t t_stack[66];
+    std::vector<uint64_t> t_heap;
+    uint64_t* t = t_stack;
+    if (s + 2 > 66) {
+      t_heap.assign(s + 2, 0);
+      t = t_heap.data();
+    } else {
+      std::fill(t, t + s + 2, 0);
+    }
+    for (size_t i = 0; i < s; ++i) {
+      unsigned __int128 carry = 0;
+      for (size_t j = 0; j < s; ++j) {
+        carry += static_cast<unsigned __int128>(a[j]) * b[i] + t[j];
+        t[j] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+      }
+      carry += t[s];
+      t[s] = static_cast<uint64_t>(carry);
+      t[s + 1] = static_cast<uint64_t>(carry >> 64);
+
+      uint64_t m = t[0] * inv_;
+      carry = static_cast<unsigned __int128>(m) * n[0] + t[0];
+      carry >>= 64;
+      for (size_t j = 1; j < s; ++j) {
+        carry += static_cast<unsigned __int128>(m) * n[j] + t[j];
+        t[j - 1] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+      }
+      carry += t[s];
+      t[s - 1] = static_cast<uint64_t>(carry);
+      t[s] = t[s + 1] + static_cast<uint64_t>(carry >> 64);
+    }
+    if (t[s] != 0 or BinaryBigInteger::compareLimbs(t, s, n, s) >= 0) {
+      BinaryBigInteger::subLimbs(t, s + 1, n, s);
+    }
+    std::copy(t, t + s, out);
+  }
+};
+
+// base^exponent mod mod для mod > 0 и exponent >= 0. Нечётный модуль - через Монтгомери,
+// иначе то же скользящее окно с делением по Кнуту
+BigInteger powmod(const BigInteger& base, const BigInteger& exponent, const BigInteger& mod) {
+  assert(exponent >= 0 and "powmod: negative exponent");
+  assert(mod > 0 and "powmod: modulus must be positive");
+  if (mod == 1) {
+    return 0;
+  }
+  if (mod % 2 != 0) {
+    return MontgomeryContext(mod).pow(base, exponent);
+  }
+  BigInteger reduced = base % mod;
+  if (reduced < 0) { reduced += mod; }
+  auto mul = [&mod](const BigInteger& x, const BigInteger& y) {
+    return x * y % mod;
+  };
+  return slidingWindowPow(reduced, BinaryBigInteger(exponent), BigInteger(1), mul);
+}
+
+// Число фиксированной ширины Bits бит в дополнительном коде на стеке: арифметика по модулю 2^Bits
+// как у встроенных целых, деление с округлением к нулю как у BigInteger. Все операции constexpr
+template <size_t Bits>
+class FixedBigInt {
+  static_assert(Bits % 64 == 0 and Bits > 0, "FixedBigInt width must be a positive multiple of 64");
+
+ public:
+  static constexpr size_t kWords = Bits / 64;
+
+  constexpr FixedBigInt() : words_{} {}
+
+  constexpr FixedBigInt(const int64_t& a) : words_{} {
+    words_[0] = static_cast<uint64_t>(a);
+    for (size_t i = 1; i < kWords; ++i) {
+      words_[i] = (a < 0 ? ~uint64_t(0) : 0);
+    }
+  }
+
+  // Десятичная запись с необязательным знаком; апострофы-разделители пропускаются.
+  // Не цифра - invalid_argument, значение вне [-2^(Bits-1), 2^(Bits-1)) - out_of_range;
+  // при вычислении на этапе компиляции это ошибка компиляции, а не неверная константа
+  explicit constexpr FixedBigInt(const char* s) : words_{} {
+    bool negative = (*s == '-');
+    if (*s == '-' or *s == '+') { ++s; }
+    parseMagnitude(s, 10, words_);
+    if ((words_[kWords - 1] >> 63) != 0 and !(negative and isMinimum())) {
+      throw std::out_of_range("FixedBigInt: value out of range");
+    }
+    if (negative) { *this = -*this; }
+  }
+
+  // Литерал без знака: 0x/0X - шестнадцатеричный, 0b/0B - двоичный, ведущий 0 - восьмеричный.
+  // Десятичный должен быть меньше 2^(Bits-1), остальные задают битовый шаблон из Bits бит
+  static constexpr FixedBigInt fromLiteral(const char* s) {
+    FixedBigInt result;
+    uint64_t radix = 10;
+    if (s[0] == '0' and (s[1] == 'x' or s[1] == 'X')) {
+      radix = 16;
+      s += 2;
+    } else if (s[0] == '0' and (s[1] == 'b' or s[1] == 'B')) {
+      radix = 2;
+      s += 2;
+    } else if (s[0] == '0' and s[1] != '\0') {
+      radix = 8;
+      ++s;
+    }
+    parseMagnitude(s, radix, result.words_);
+    if (radix == 10 and (result.words_[kWords - 1] >> 63) != 0) {
+      throw std::out_of_range("FixedBigInt: literal out of range");
+    }
+    return result;
+  }
+
+  explicit FixedBigInt(const std::string& s) : FixedBigInt(s.c_str()) {}
+
+  // Значение берётся по модулю 2^Bits: без потерь, если a помещается в Bits бит со знаком
+  explicit FixedBigInt(const BigInteger& a) : words_{} {
+    for (size_t j = a.digits_.size(); j-- > 0;) {
+      mulSmall(words_, BigInteger::base, static_cast<uint64_t>(a.digits_[j]));
+    }
+    if (!a.sign_) { *this = -*this; }
+  }
+
+  BigInteger toBigInteger() const {
+    uint64_t magnitude[kWords] = {};
+    copyMagnitude(magnitude);
+    BigInteger result;
+    result.digits_.clear();
+    do {
+      result.digits_.push_back(static_cast<int64_t>(divSmall(magnitude, BigInteger::base)));
+    } while (!isZero(magnitude));
+    result.sign_ = !isNegative();
+    result.clear();
+    return result;
+  }
+
+  std::string toString() const {
+    return toBigInteger().toString();
+  }
+
+  constexpr bool isNegative() const {
+    return (words_[kWords - 1] >> 63) != 0;
+  }
+
+  constexpr explicit operator bool() const {
+    return !isZero(words_);
+  }
+
+  // Слово с номером index, младшее - нулевое
+  constexpr uint64_t word(size_t index) const {
+    return words_[index];
+  }
+
+  constexpr FixedBigInt operator+() const {
+    return *this;
+  }
+
+  constexpr FixedBigInt operator-() const {
+    FixedBigInt result;
+    uint64_t carry = 1;
+    for (size_t i = 0; i < kWords; ++i) {
+      result.words_[i] = ~words_[i] + carry;
+      carry = (carry != 0 and result.words_[i] == 0);
+    }
+    return result;
+  }
+
+  constexpr FixedBigInt& operator+=(const FixedBigInt& other) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < kWords; ++i) {
+      unsigned __int128 sum = static_cast<unsigned __int128>(words_[i]) + other.words_[i] + carry;
+      words_[i] = static_cast<uint64_t>(sum);
+      carry = static_cast<uint64_t>(sum >> 64);
+    }
+    return *this;
+  }
+
+  constexpr FixedBigInt& operator-=(const FixedBigInt& other) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < kWords; ++i) {
+      uint64_t difference = words_[i] - other.words_[i] - borrow;
+      borrow = (words_[i] < other.words_[i] or (words_[i] == other.words_[i] and borrow != 0));
+      words_[i] = difference;
+    }
+    return *this;
+  }
+
+  // Младшие kWords слов произведения - верный результат и для отрицательных чисел
+  constexpr FixedBigInt& operator*=(const FixedBigInt& other) {
+    uint64_t result[kWords] = {};
+    for (size_t i = 0; i < kWords; ++i) {
+      if (words_[i] == 0) { continue; }
+      uint64_t carry = 0;
+      for (size_t j = 0; i + j < kWords; ++j) {
+        unsigned __int128 tmp = static_cast<unsigned __int128>(words_[i]) * other.words_[j] + result[i + j] + carry;
+        result[i + j] = static_cast<uint64_t>(tmp);
+        carry = static_cast<uint64_t>(tmp >> 64);
+      }
+    }
+    for (size_t i = 0; i < kWords; ++i) { words_[i] = result[i]; }
+    return *this;
+  }
+
+  constexpr FixedBigInt& operator/=(const FixedBigInt& other) {
+    divMod(*this, other, this, nullptr);
+    return *this;
+  }
+
+  constexpr FixedBigInt& operator%=(const FixedBigInt& other) {
+    divMod(*this, other, nullptr, this);
+    return *this;
+  }
+
+  constexpr FixedBigInt& operator++() {
+    return *this += 1;
+  }
+
+  constexpr FixedBigInt operator++(int) {
+    FixedBigInt copy = *this;
+    *this += 1;
+    return copy;
+  }
+
+  constexpr FixedBigInt& operator--() {
+    return *this -= 1;
+  }
+
+  constexpr FixedBigInt operator--(int) {
+    FixedBigInt copy = *this;
+    *this -= 1;
+    return copy;
+  }
+
+  // Дружественные функции внутри класса, чтобы работали неявные преобразования (x + 1)
+  friend constexpr FixedBigInt operator+(FixedBigInt a, const FixedBigInt& b) {
+    return a += b;
+  }
+
+  friend constexpr FixedBigInt operator-(FixedBigInt a, const FixedBigInt& b) {
+    return a -= b;
+  }
+
+  friend constexpr FixedBigInt operator*(FixedBigInt a, const FixedBigInt& b) {
+    return a *= b;
+  }
+
+  friend constexpr FixedBigInt operator/(FixedBigInt a, const FixedBigInt& b) {
+    return a /= b;
+  }
 
-BigInteger gcd(const BigInteger& a, const BigInteger& b) {
-  BigInteger tmp_a = a >= 0 ? a : -a;
-  BigInteger tmp_b = b >= 0 ? b : -b;
-  while (tmp_a != 0 and tmp_b != 0) {
-    if (tmp_a > tmp_b) {
-      tmp_a %= tmp_b;
-    } else {
-      tmp_b %= tmp_a;
+  friend constexpr FixedBigInt operator%(FixedBigInt a, const FixedBigInt& b) {
+    return a %= b;
+  }
+
+  friend constexpr bool operator==(const FixedBigInt& a, const FixedBigInt& b) {
+    for (size_t i = 0; i < kWords; ++i) {
+      if (a.words_[i] != b.words_[i]) { return false; }
+    }
+    return true;
+  }
+
+  friend constexpr bool operator!=(const FixedBigInt& a, const FixedBigInt& b) {
+    return !(a == b);
+  }
+
+  friend constexpr bool operator<(const FixedBigInt& a, const FixedBigInt& b) {
+    if (a.isNegative() != b.isNegative()) {
+      return a.isNegative();
+    }
+    for (size_t i = kWords; i-- > 0;) {
+      if (a.words_[i] != b.words_[i]) { return a.words_[i] < b.words_[i]; }
+    }
+    return false;
+  }
+
+  friend constexpr bool operator>(const FixedBigInt& a, const FixedBigInt& b) {
+    return b < a;
+  }
+
+  friend constexpr bool operator<=(const FixedBigInt& a, const FixedBigInt& b) {
+    return !(b < a);
+  }
+
+  friend constexpr bool operator>=(const FixedBigInt& a, const FixedBigInt& b) {
+    return !(a < b);
+  }
+
+  friend std::ostream& operator<<(std::ostream& out, const FixedBigInt& a) {
+    out << a.toBigInteger();
+    return out;
+  }
+
+  friend std::istream& operator>>(std::istream& in, FixedBigInt& a) {
+    BigInteger decimal;
+    in >> decimal;
+    a = FixedBigInt(decimal);
+    return in;
+  }
+
+ private:
+  uint64_t words_[kWords];
+
+  static constexpr bool isZero(const uint64_t* a) {
+    for (size_t i = 0; i < kWords; ++i) {
+      if (a[i] != 0) { return false; }
+    }
+    return true;
+  }
+
+  // a = a * factor + addend по модулю 2^Bits, возвращает перенос за старшее слово
+  static constexpr uint64_t mulSmall(uint64_t* a, uint64_t factor, uint64_t addend) {
+    uint64_t carry = addend;
+    for (size_t i = 0; i < kWords; ++i) {
+      unsigned __int128 tmp = static_cast<unsigned __int128>(a[i]) * factor + carry;
+      a[i] = static_cast<uint64_t>(tmp);
+      carry = static_cast<uint64_t>(tmp >> 64);
+    }
+    return carry;
+  }
+
+  static constexpr uint64_t digitValue(char c) {
+    if (c >= '0' and c <= '9') { return static_cast<uint64_t>(c - '0'); }
+    if (c >= 'a' and c <= 'f') { return static_cast<uint64_t>(c - 'a' + 10); }
+    if (c >= 'A' and c <= 'F') { return static_cast<uint64_t>(c - 'A' + 10); }
+    return 16;
+  }
+
+  // Модуль в системе radix (хотя бы одна цифра, апострофы пропускаются) без переполнения Bits бит
+  static constexpr void parseMagnitude(const char* s, uint64_t radix, uint64_t* words) {
+    bool any = false;
+    for (; *s != '\0'; ++s) {
+      if (*s == '\'') { continue; }
+      uint64_t digit = digitValue(*s);
+      if (digit >= radix) {
+        throw std::invalid_argument("FixedBigInt: invalid digit");
+      }
+      if (mulSmall(words, radix, digit) != 0) {
+        throw std::out_of_range("FixedBigInt: value out of range");
+      }
+      any = true;
+    }
+    if (!any) {
+      throw std::invalid_argument("FixedBigInt: no digits");
+    }
+  }
+
+  constexpr bool isMinimum() const {
+    for (size_t i = 0; i + 1 < kWords; ++i) {
+      if (words_[i] != 0) { return false; }
+    }
+    return words_[kWords - 1] == (uint64_t(1) << 63);
+  }
+
+  // a /= divisor, возвращает остаток
+  static constexpr uint64_t divSmall(uint64_t* a, uint64_t divisor) {
+    unsigned __int128 remainder = 0;
+    for (size_t i = kWords; i-- > 0;) {
+      unsigned __int128 current = (remainder << 64) | a[i];
+      a[i] = static_cast<uint64_t>(current / divisor);
+      remainder = current % divisor;
+    }
+    return static_cast<uint64_t>(remainder);
+  }
+
+  constexpr void copyMagnitude(uint64_t* out) const {
+    FixedBigInt magnitude = (isNegative() ? -*this : *this);
+    for (size_t i = 0; i < kWords; ++i) { out[i] = magnitude.words_[i]; }
+  }
+
+  // Алгоритм D Кнута на 64-битных словах; знаки как у BigInteger: частное к нулю, остаток со знаком a
+  static constexpr void divMod(const FixedBigInt& a, const FixedBigInt& b, FixedBigInt* quotient, FixedBigInt* remainder) {
+    uint64_t u[kWords + 1] = {};
+    uint64_t v[kWords] = {};
+    a.copyMagnitude(u);
+    b.copyMagnitude(v);
+    bool quotient_negative = (a.isNegative() != b.isNegative());
+    bool remainder_negative = a.isNegative();
+    size_t n = kWords;
+    while (n > 0 and v[n - 1] == 0) { --n; }
+    size_t m = kWords;
+    while (m > 0 and u[m - 1] == 0) { --m; }
+    FixedBigInt q;
+    FixedBigInt r;
+    if (m < n) {
+      for (size_t i = 0; i < kWords; ++i) { r.words_[i] = u[i]; }
+    } else if (n == 1) {
+      uint64_t rest = divSmall(u, v[0]);
+      for (size_t i = 0; i < kWords; ++i) { q.words_[i] = u[i]; }
+      r.words_[0] = rest;
+    } else if constexpr (kWords > 1) {
+      // Нормализация: старший бит делителя равен 1
+      int shift = __builtin_clzll(v[n - 1]);
+      if (shift > 0) {
+        for (size_t i = n; i-- > 1;) { v[i] = (v[i] << shift) | (v[i - 1] >> (64 - shift)); }
+        v[0] <<= shift;
+        u[m] = u[m - 1] >> (64 - shift);
+        for (size_t i = m; i-- > 1;) { u[i] = (u[i] << shift) | (u[i - 1] >> (64 - shift)); }
+        u[0] <<= shift;
+      }
+      for (size_t j = m - n + 1; j-- > 0;) {
+        unsigned __int128 numerator = (static_cast<unsigned __int128>(u[j + n]) << 64) | u[j + n - 1];
+        unsigned __int128 q_hat = numerator / v[n - 1];
+        unsigned __int128 r_hat = numerator % v[n - 1];
+        while ((q_hat >> 64) != 0 or
+               q_hat * v[n - 2] > ((r_hat << 64) | u[j + n - 2])) {
+          --q_hat;
+          r_hat += v[n - 1];
+          if ((r_hat >> 64) != 0) { break; }
+        }
+        // u[j..j+n] -= q_hat * v
+        __int128 borrow = 0;
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+          unsigned __int128 product = q_hat * v[i] + carry;
+          carry = static_cast<uint64_t>(product >> 64);
+          __int128 t = static_cast<__int128>(u[i + j]) - static_cast<uint64_t>(product) + borrow;
+          u[i + j] = static_cast<uint64_t>(t);
+          borrow = t >> 64;
+        }
+        __int128 t = static_cast<__int128>(u[j + n]) - carry + borrow;
+        u[j + n] = static_cast<uint64_t>(t);
+        if (t < 0) {
+          --q_hat;
+          uint64_t add_carry = 0;
+          for (size_t i = 0; i < n; ++i) {
+            unsigned __int128 sum = static_cast<unsigned __int128>(u[i + j]) + v[i] + add_carry;
+            u[i + j] = static_cast<uint64_t>(sum);
+            add_carry = static_cast<uint64_t>(sum >> 64);
+          }
+          u[j + n] += add_carry;
+        }
+        q.words_[j] = static_cast<uint64_t>(q_hat);
+      }
+      for (size_t i = 0; i < n; ++i) {
+        r.words_[i] = (shift > 0 ? (u[i] >> shift) | (u[i + 1] << (64 - shift)) : u[i]);
+      }
     }
+    if (quotient != nullptr) { *quotient = (quotient_negative ? -q : q); }
+    if (remainder != nullptr) { *remainder = (remainder_negative ? -r : r); }
   }
-  return (tmp_a + tmp_b);
+};
+
+using Int256 = FixedBigInt<256>;
+using Int512 = FixedBigInt<512>;
+
+// Литерал _bi уже занят BigInteger, поэтому у фиксированных ширин свои суффиксы. Разбор всегда
+// на этапе компиляции: неверная цифра или переполнение - ошибка компиляции
+template <char... Digits>
+constexpr Int256 operator ""_bi256() {
+  constexpr char s[] = {Digits..., '\0'};
+  constexpr Int256 value = Int256::fromLiteral(s);
+  return value;
+}
+
+template <char... Digits>
+constexpr Int512 operator ""_bi512() {
+  constexpr char s[] = {Digits..., '\0'};
+  constexpr Int512 value = Int512::fromLiteral(s);
+  return value;
 }
 
 class Rational {
  public:
 
+  // Когда сокращать дробь: после каждой операции, когда знаменатель заметно вырос
+  // с последнего сокращения (lazy_threshold - запас в десятичных цифрах) или только при выводе
+  enum class Normalization { always, lazy, never };
+  inline static Normalization normalization = Normalization::always;
+  inline static size_t lazy_threshold = 64;
+
   Rational(const int64_t& a) {
     numerator_ = BigInteger(a);
     denominator_ = BigInteger(1);
@@ -496,6 +3157,9 @@ class Rational {
       numerator_ = a;
       denominator_ = b;
     }
+    if (normalization == Normalization::never) {
+      return;
+    }
     this->decrease();
   }
 
@@ -512,46 +3176,139 @@ class Rational {
     }
   }
 
-  std::string asDecimal(size_t precision = 0) {
-    bool sign;
-    BigInteger tmp_numerator = numerator_;
-    if (tmp_numerator >= 0) {
-      sign = true;
-    } else {
-      tmp_numerator = -tmp_numerator;
-      sign = false;
+  // Цифры дробной части |x| блоками по 9: на каждом шаге остаток умножается на 10^9
+  // и делится на знаменатель, частное - очередной блок
+  class DecimalExpansion {
+   public:
+    explicit DecimalExpansion(const Rational& x) : denominator_(x.denominator_) {
+      std::pair<BigInteger, BigInteger> parts = divmod(x.numerator_ < 0 ? -x.numerator_ : x.numerator_, denominator_);
+      whole_ = std::move(parts.first);
+      remainder_ = std::move(parts.second);
     }
-    BigInteger whole_part = tmp_numerator / denominator_;
-    BigInteger fractional_part = tmp_numerator % denominator_;
-    std::string answer;
-    if (!sign) {
-      answer += '-';
-    }
-    BigInteger tmp(10);
-    for (uint64_t i = 0; i < precision + 1; ++i) {
-      fractional_part *= 10;
-      tmp += fractional_part / denominator_;
-      if (i != precision) { tmp *= 10; }
-      fractional_part %= denominator_;
-    }
-    if ((tmp % 10) >= 5 and (tmp % 10) != 9) {
-      tmp /= 10;
-      tmp += 1;
-    } else {
-      tmp /= 10;
+
+    const BigInteger& whole() const {
+      return whole_;
+    }
+
+    uint32_t next() {
+      remainder_.shiftLeft(1);
+      std::pair<BigInteger, BigInteger> parts = divmod(remainder_, denominator_);
+      remainder_ = std::move(parts.second);
+      return static_cast<uint32_t>(parts.first.digits_[0]);
     }
-    std::string second_part = tmp.toString();
 
-    answer += whole_part.toString();
-    if (precision > 0) {
-      answer += '.';
-      answer += second_part.substr(1);
+   private:
+    BigInteger denominator_;
+    BigInteger whole_;
+    BigInteger remainder_;
+  };
+
+  // Пишет x с precision знаками после точки (половина округляется от нуля) в sink(data, size).
+  // Блоки из одних девяток и целая часть придерживаются, пока неизвестен перенос от округления
+  template <typename Sink>
+  void streamDecimal(Sink sink, size_t precision) const {
+    static constexpr uint32_t kPowers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    static constexpr uint32_t kNines = 999999999;
+    auto write_block = [&sink](uint32_t block, size_t width) {
+      char buffer[9];
+      for (size_t j = width; j-- > 0; block /= 10) {
+        buffer[j] = static_cast<char>('0' + block % 10);
+      }
+      sink(buffer, width);
+    };
+
+    DecimalExpansion digits(*this);
+    if (numerator_ < 0) {
+      sink("-", 1);
+    }
+    BigInteger whole = digits.whole();
+    bool whole_held = true;
+    uint32_t held = 0;
+    size_t nines = 0;
+    auto flush = [&](bool carry) {
+      if (whole_held) {
+        if (carry) { ++whole; }
+        std::string str = whole.toString();
+        sink(str.data(), str.size());
+        if (precision > 0) { sink(".", 1); }
+        whole_held = false;
+      } else {
+        write_block(held + static_cast<uint32_t>(carry), 9);
+      }
+      for (; nines > 0; --nines) {
+        write_block(carry ? 0 : kNines, 9);
+      }
+    };
+
+    for (size_t i = 0; i < precision / 9; ++i) {
+      uint32_t block = digits.next();
+      if (block == kNines) {
+        ++nines;
+      } else {
+        flush(false);
+        held = block;
+      }
+    }
+    // Последние precision % 9 цифр и следующая за ними цифра для округления
+    size_t rest = precision % 9;
+    uint32_t block = digits.next();
+    uint32_t tail = block / kPowers[9 - rest];
+    bool carry = false;
+    if (block / kPowers[8 - rest] % 10 >= 5 and ++tail == kPowers[rest]) {
+      tail = 0;
+      carry = true;
     }
+    flush(carry);
+    write_block(tail, rest);
+  }
+
+  void writeDecimal(std::ostream& out, size_t precision) const {
+    streamDecimal([&out](const char* data, size_t size) { out.write(data, static_cast<std::streamsize>(size)); }, precision);
+  }
+
+  std::string asDecimal(size_t precision = 0) const {
+    std::string answer;
+    streamDecimal([&answer](const char* data, size_t size) { answer.append(data, size); }, precision);
     return answer;
   }
 
-  explicit operator double() {
-    return (std::stod(asDecimal(10)));
+  // Корректно округлённое (к ближайшему, к чётному при равенстве) значение дроби
+  explicit operator double() const {
+    const LimbStorage& a = numerator_.digits_;
+    const LimbStorage& b = denominator_.digits_;
+    // Оба числа точно представимы в double - одно деление IEEE уже округляет корректно
+    if (a.size() <= 2 and b.size() <= 2) {
+      int64_t x = a[0] + (a.size() == 2 ? a[1] * BigInteger::base : 0);
+      int64_t y = b[0] + (b.size() == 2 ? b[1] * BigInteger::base : 0);
+      if (x < (int64_t(1) << 53) and y < (int64_t(1) << 53)) {
+        return (numerator_.sign_ ? 1.0 : -1.0) * static_cast<double>(x) / static_cast<double>(y);
+      }
+    }
+    return toDouble(numerator_, denominator_);
+  }
+
+  // Точное значение x (x конечно), дробь сразу несократима
+  static Rational fromDouble(double x) {
+    Rational result;
+    if (x == 0) {
+      return result;
+    }
+    int exponent;
+    double fraction = std::frexp(x, &exponent);
+    int64_t mantissa = static_cast<int64_t>(std::ldexp(fraction, 53));
+    exponent -= 53;
+    while (exponent < 0 and mantissa % 2 == 0) {
+      mantissa /= 2;
+      ++exponent;
+    }
+    result.numerator_ = mantissa;
+    if (exponent > 0) {
+      result.numerator_ *= pow(BigInteger(2), static_cast<uint64_t>(exponent));
+    } else if (exponent < 0) {
+      result.denominator_ = pow(BigInteger(2), static_cast<uint64_t>(-exponent));
+    }
+    result.reduced_length_ = length(result.denominator_);
+    return result;
   }
 
   Rational operator+() const {
@@ -561,55 +3318,295 @@ class Rational {
   Rational operator-() const;
 
   Rational& operator+=(const Rational& other) {
-    BigInteger new_numerator = (this->numerator_ * other.denominator_) + (this->denominator_ * other.numerator_);
-    BigInteger new_denominator = (this->denominator_ * other.denominator_);
-    this->denominator_ = new_denominator;
-    this->numerator_ = new_numerator;
+    this->addScaled(other.numerator_, other.denominator_, true);
     return *this;
   }
 
   Rational& operator-=(const Rational& other) {
-    BigInteger new_numerator = (this->numerator_ * other.denominator_) - (this->denominator_ * other.numerator_);
-    BigInteger new_denominator = (this->denominator_ * other.denominator_);
-    this->denominator_ = new_denominator;
-    this->numerator_ = new_numerator;
+    this->addScaled(other.numerator_, other.denominator_, false);
     return *this;
   }
 
   Rational& operator*=(const Rational& other) {
-    this->numerator_ *= (other.numerator_);
-    this->denominator_ *= (other.denominator_);
+    this->multiply(other.numerator_, other.denominator_);
     return *this;
   }
 
   Rational& operator/=(const Rational& other) {
     if (other.numerator_ < 0) {
-      this->numerator_ *= -(other.denominator_);
-      this->denominator_ *= -(other.numerator_);
+      this->multiply(-other.denominator_, -other.numerator_);
     } else {
-      this->numerator_ *= (other.denominator_);
-      this->denominator_ *= (other.numerator_);
+      this->multiply(other.denominator_, other.numerator_);
     }
     return *this;
   }
 
   friend bool operator<(const Rational& a, const Rational& b);
+  friend bool operator==(const Rational& a, const Rational& b);
+  friend size_t maxSerializedSize(const Rational& value, WireRadix radix);
+  friend std::to_chars_result serialize(char* first, char* last, const Rational& value, WireRadix radix);
+  friend std::from_chars_result deserialize(const char* first, const char* last, Rational& value);
 
  private:
   BigInteger numerator_;
   BigInteger denominator_;
+  size_t reduced_length_ = 0; // Длина знаменателя после последнего сокращения
+
+  static size_t length(const BigInteger& a) {
+    return a.decimalLength() - static_cast<size_t>(a < 0);
+  }
+
+  // Корректное округление |a| / b. Быстрый путь: оба числа обрезаются до старших лимбов с одной
+  // и той же позиции (base^e сокращается), частное считается по обрезкам, а отброшенные лимбы дают
+  // известную границу ошибки. Если вся окрестность частного округляется в одно и то же число,
+  // оно и есть ответ; иначе - точное деление целых чисел
+  static double toDouble(const BigInteger& numerator, const BigInteger& denominator) {
+    static constexpr double kLog2Of10 = 3.321928094887362;
+    if (numerator == 0) {
+      return 0.0;
+    }
+    double sign = (numerator < 0 ? -1.0 : 1.0);
+    int64_t difference = static_cast<int64_t>(length(numerator)) - static_cast<int64_t>(length(denominator));
+    // log2(|a| / b) лежит в ((difference - 1) * log2(10), (difference + 1) * log2(10))
+    double lower = static_cast<double>(difference - 1) * kLog2Of10;
+    if (lower >= 1024) {
+      return sign * HUGE_VAL;
+    } else if (static_cast<double>(difference + 1) * kLog2Of10 < -1076) {
+      return sign * 0.0;
+    }
+
+    const LimbStorage& a = numerator.digits_;
+    const LimbStorage& b = denominator.digits_;
+    size_t longest = std::max(a.size(), b.size());
+    size_t shortest = std::min(a.size(), b.size());
+    size_t e = (longest > kTopLimbs ? longest - kTopLimbs : 0);
+    // Длины различаются не больше чем на лимб: обрезки помещаются в 128 бит, и у каждой остаётся
+    // не меньше трёх лимбов (относительная ошибка < 10^-18). Хватает одного 128-битного деления
+    if (e == 0 or shortest >= e + kTopLimbs - 1) {
+      unsigned __int128 x = topLimbs(a, e);
+      unsigned __int128 y = topLimbs(b, e);
+      int64_t shift = 127 - bitLength(x); // x * 2^shift < 2^127: частное и его окрестность в 128 битах
+      int64_t t = std::max<int64_t>(bitLength(y) - 64, 0);
+      unsigned __int128 divisor = y >> t;
+      unsigned __int128 q = (x << shift) / divisor;
+      // |a| / b * 2^(shift + t) лежит в (q - error, q + 1 + error)
+      unsigned __int128 error = 1;
+      if (e > 0 or t > 0) {
+        error += 2 * (q / divisor) + 2;
+      }
+      if (e > 0) {
+        error += q / x + 1;
+      }
+      double low = roundScaled(q - error, shift + t, true);
+      if (low == roundScaled(q + 1 + error, shift + t, true)) {
+        return sign * low;
+      }
+    }
+
+    // q = floor(|a| * 2^s / b) из 64-72 бит (s подбирается по десятичным длинам); обрезка на
+    // одной позиции не меняет разность длин, поэтому s подходит и для обрезанных чисел
+    int64_t s = 64 - static_cast<int64_t>(std::floor(lower));
+    if (shortest > kTopLimbs) {
+      // У более короткого числа остаётся kTopLimbs лимбов, у длинного - на разность длин больше
+      // (в пределах диапазона double это десятки лимбов). Обе обрезки не меньше 10^27, а q < 2^73,
+      // поэтому отброшенное меняет частное меньше чем на единицу
+      size_t from = shortest - kTopLimbs;
+      unsigned __int128 q = 0;
+      scaledQuotient(dropLimbs(numerator, from), dropLimbs(denominator, from), s, q);
+      double low = roundScaled(q - 2, s, true);
+      if (low == roundScaled(q + 2, s, true)) {
+        return sign * low;
+      }
+    }
+    unsigned __int128 q = 0;
+    bool sticky = scaledQuotient(numerator, denominator, s, q);
+    return sign * roundScaled(q, s, sticky);
+  }
+
+  // q = floor(|a| * 2^s / b); возвращает признак ненулевого остатка
+  static bool scaledQuotient(const BigInteger& a, const BigInteger& b, int64_t s, unsigned __int128& q) {
+    BigInteger scaled_numerator = (a < 0 ? -a : a);
+    BigInteger scaled_denominator = b;
+    if (s > 0) {
+      scaled_numerator *= pow(BigInteger(2), static_cast<uint64_t>(s));
+    } else if (s < 0) {
+      scaled_denominator *= pow(BigInteger(2), static_cast<uint64_t>(-s));
+    }
+    std::pair<BigInteger, BigInteger> parts = divmod(scaled_numerator, scaled_denominator);
+    q = topLimbs(parts.first.digits_, 0);
+    return parts.second != 0;
+  }
+
+  // floor(|a| / base^from)
+  static BigInteger dropLimbs(const BigInteger& a, size_t from) {
+    BigInteger result;
+    result.digits_.assign(a.digits_.begin() + from, a.digits_.end());
+    return result;
+  }
+
+  // 4 лимба по основанию 10^9 меньше 2^120
+  static constexpr size_t kTopLimbs = 4;
+
+  // Старшие лимбы, начиная с from (не больше kTopLimbs штук): floor(|a| / base^from)
+  static unsigned __int128 topLimbs(const LimbStorage& a, size_t from) {
+    unsigned __int128 value = 0;
+    for (size_t j = a.size(); j-- > from;) {
+      value = value * BigInteger::base + static_cast<uint64_t>(a[j]);
+    }
+    return value;
+  }
+
+  static int64_t bitLength(unsigned __int128 value) {
+    uint64_t high = static_cast<uint64_t>(value >> 64);
+    uint64_t low = static_cast<uint64_t>(value);
+    if (high != 0) {
+      return 128 - __builtin_clzll(high);
+    }
+    return (low != 0 ? 64 - __builtin_clzll(low) : 0);
+  }
+
+  // value * 2^-s, округлённое к ближайшему (к чётному при равенстве); sticky - к value добавлена
+  // ненулевая дробь меньше единицы. value должно занимать не меньше 54 бит
+  static double roundScaled(unsigned __int128 value, int64_t s, bool sticky) {
+    int64_t bits = bitLength(value);
+    // Младший бит результата: 53 значащих бита, но не мельче 2^-1074
+    int64_t lsb = std::max<int64_t>(bits - 53 - s, -1074);
+    int64_t drop = lsb + s;
+    uint64_t mantissa = 0;
+    if (drop <= bits) {
+      unsigned __int128 rest = value & ((static_cast<unsigned __int128>(1) << drop) - 1);
+      unsigned __int128 half = static_cast<unsigned __int128>(1) << (drop - 1);
+      mantissa = static_cast<uint64_t>(value >> drop);
+      if (rest > half or (rest == half and (sticky or (mantissa & 1) != 0))) {
+        ++mantissa;
+      }
+    }
+    return std::ldexp(static_cast<double>(mantissa), static_cast<int>(lsb));
+  }
+
+  static int signum(const BigInteger& a) {
+    return (a < 0 ? -1 : (a == 0 ? 0 : 1));
+  }
+
+  // *this += c / d (или -= при add == false), d > 0. Сначала делим на g = gcd(b, d):
+  // a / b + c / d = (a * (d / g) + c * (b / g)) / (b * d / g), а в режиме always
+  // сокращать остаётся только на gcd(числитель, g)
+  void addScaled(const BigInteger& c, const BigInteger& d, bool add) {
+    if (normalization == Normalization::never) {
+      BigInteger new_numerator;
+      mul(new_numerator, numerator_, d);
+      add ? addmul(new_numerator, denominator_, c) : submul(new_numerator, denominator_, c);
+      denominator_ *= d;
+      numerator_ = std::move(new_numerator);
+      return;
+    }
+    if (denominator_ == d) {
+      add ? numerator_ += c : numerator_ -= c;
+      if (normalization == Normalization::always) {
+        this->decrease();
+      }
+      return;
+    }
+    BigInteger g = gcd(denominator_, d);
+    BigInteger new_numerator;
+    if (g == 1) {
+      mul(new_numerator, numerator_, d);
+      add ? addmul(new_numerator, denominator_, c) : submul(new_numerator, denominator_, c);
+      denominator_ *= d;
+      numerator_ = std::move(new_numerator);
+    } else {
+      BigInteger d_reduced = d / g;
+      BigInteger b_reduced = denominator_ / g;
+      mul(new_numerator, numerator_, d_reduced);
+      add ? addmul(new_numerator, b_reduced, c) : submul(new_numerator, b_reduced, c);
+      if (normalization == Normalization::always) {
+        BigInteger common = gcd(new_numerator, g);
+        if (common != 1) {
+          new_numerator /= common;
+        }
+        mul(denominator_, b_reduced, (common == 1 ? d : d / common));
+      } else {
+        denominator_ *= d_reduced;
+      }
+      numerator_ = std::move(new_numerator);
+    }
+    // gcd(0, g) = g, так что ноль сам не сократится до 0 / 1
+    if (normalization == Normalization::always and numerator_ == 0) {
+      denominator_ = 1;
+    }
+    this->normalizeLazy();
+  }
+
+  // *this *= c / d, d > 0. В режиме always сокращаются крест-накрест: gcd(a, d) и gcd(c, b)
+  void multiply(const BigInteger& c, const BigInteger& d) {
+    if (normalization != Normalization::always) {
+      BigInteger new_numerator;
+      BigInteger new_denominator;
+      mul(new_numerator, numerator_, c);
+      mul(new_denominator, denominator_, d);
+      numerator_ = std::move(new_numerator);
+      denominator_ = std::move(new_denominator);
+      this->normalizeLazy();
+      return;
+    }
+    BigInteger first = gcd(numerator_, d);
+    BigInteger second = gcd(c, denominator_);
+    BigInteger new_numerator = (first == 1 ? numerator_ : numerator_ / first);
+    BigInteger new_denominator = (second == 1 ? denominator_ : denominator_ / second);
+    new_numerator *= (second == 1 ? c : c / second);
+    new_denominator *= (first == 1 ? d : d / first);
+    numerator_ = std::move(new_numerator);
+    denominator_ = std::move(new_denominator);
+    if (numerator_ == 0) {
+      denominator_ = 1;
+    }
+  }
+
+  void normalizeLazy() {
+    if (normalization == Normalization::lazy and length(denominator_) > 2 * reduced_length_ + lazy_threshold) {
+      this->decrease();
+    }
+  }
 
   void decrease() {
     if (numerator_ == 0) {
       denominator_ = 1;
-      return;
-    } else if (denominator_ == 1) {
-      return;
+    } else if (denominator_ != 1) {
+      BigInteger decr = gcd(numerator_, denominator_);
+      if (decr != 1) {
+        numerator_ /= decr;
+        denominator_ /= decr;
+      }
+    }
+    reduced_length_ = length(denominator_);
+  }
+
+  // Сравнение без перемножения, если хватает знаков, общего знаменателя или оценки длин
+  static int compare(const Rational& a, const Rational& b) {
+    int sign_a = signum(a.numerator_);
+    int sign_b = signum(b.numerator_);
+    if (sign_a != sign_b) {
+      return (sign_a < sign_b ? -1 : 1);
     }
-    BigInteger tmp_numerator = (numerator_ >= 0 ? numerator_ : -numerator_);
-    BigInteger decr = gcd(numerator_, denominator_);
-    numerator_ /= decr;
-    denominator_ /= decr;
+    if (sign_a == 0) {
+      return 0;
+    }
+    if (a.denominator_ == b.denominator_) {
+      return (a.numerator_ < b.numerator_ ? -1 : (b.numerator_ < a.numerator_ ? 1 : 0));
+    }
+    // x из L цифр лежит в [10^(L - 1), 10^L), поэтому разница длин произведений в 2 цифры решает
+    size_t left = length(a.numerator_) + length(b.denominator_);
+    size_t right = length(b.numerator_) + length(a.denominator_);
+    if (left + 1 < right) {
+      return -sign_a;
+    } else if (right + 1 < left) {
+      return sign_a;
+    }
+    BigInteger left_product;
+    BigInteger right_product;
+    mul(left_product, a.numerator_, b.denominator_);
+    mul(right_product, b.numerator_, a.denominator_);
+    return (left_product < right_product ? -1 : (right_product < left_product ? 1 : 0));
   }
 };
 
@@ -638,11 +3635,13 @@ Rational operator/(const Rational& a, const Rational& b) {
 }
 
 Rational Rational::operator-() const {
-  return (-1 * *this);
+  Rational answer = *this;
+  answer.numerator_ = -answer.numerator_;
+  return answer;
 }
 
 bool operator<(const Rational& a, const Rational& b) {
-  return ((a.numerator_ * b.denominator_) < (b.numerator_ * a.denominator_));
+  return Rational::compare(a, b) < 0;
 }
 
 bool operator>(const Rational& a, const Rational& b) {
@@ -658,9 +3657,276 @@ bool operator<=(const Rational& a, const Rational& b) {
 }
 
 bool operator==(const Rational& a, const Rational& b) {
-  return (!(a < b) and !(a > b));
+  return Rational::compare(a, b) == 0;
 }
 
 bool operator!=(const Rational& a, const Rational& b) {
   return !(a == b);
 }
+
+// Двоичный формат: varint-заголовок (LEB128) count * 4 + radix * 2 + negative, затем count
+// лимбов модуля little-endian - по 8 байт для WireRadix::binary и по 4 для WireRadix::decimal.
+// Ноль - заголовок с count = 0 без лимбов: байт 0 для binary, 2 для decimal.
+// Rational - числитель, затем знаменатель
+
+// nullptr, если не хватило места
+char* writeVarint(char* first, char* last, uint64_t value) {
+  for (; first != last; ++first) {
+    if (value < 0x80) {
+      *first = static_cast<char>(value);
+      return first + 1;
+    }
+    *first = static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  return nullptr;
+}
+
+// nullptr, если байты кончились раньше значения или оно не влезает в 64 бита
+const char* readVarint(const char* first, const char* last, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; first != last and shift < 64; shift += 7) {
+    uint64_t byte = static_cast<unsigned char>(*first++);
+    if (shift == 63 and byte > 1) {
+      return nullptr;
+    }
+    value |= (byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      return first;
+    }
+  }
+  return nullptr;
+}
+
+// Побайтовая запись не зависит от порядка байт платформы; на little-endian
+// компилятор сворачивает цикл в одну загрузку или запись
+template<class Word>
+void storeLittleEndian(char* out, Word word) {
+  for (size_t i = 0; i < sizeof(Word); ++i) {
+    out[i] = static_cast<char>(word >> (8 * i));
+  }
+}
+
+template<class Word>
+Word loadLittleEndian(const char* in) {
+  Word word = 0;
+  for (size_t i = 0; i < sizeof(Word); ++i) {
+    word |= static_cast<Word>(static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  return word;
+}
+
+template<class Word, class Limb>
+std::to_chars_result writeLimbs(char* first, char* last, uint64_t header, const Limb* limbs, size_t count) {
+  char* end = writeVarint(first, last, header);
+  if (end == nullptr or static_cast<size_t>(last - end) / sizeof(Word) < count) {
+    return {last, std::errc::value_too_large};
+  }
+  for (size_t i = 0; i < count; ++i, end += sizeof(Word)) {
+    storeLittleEndian(end, static_cast<Word>(limbs[i]));
+  }
+  return {end, std::errc()};
+}
+
+// Верхняя оценка размера serialize(value, radix) без перевода в двоичную систему
+size_t maxSerializedSize(const BigInteger& value, WireRadix radix = WireRadix::binary) {
+  size_t digits = value.decimalLength();
+  if (radix == WireRadix::decimal) {
+    return 10 + 4 * (digits / 9 + 1);
+  }
+  // Бит не больше digits * log2(10) + 1 < digits * 10 / 3 + 1
+  return 10 + 8 * ((digits * 10 / 3 + 64) / 64);
+}
+
+size_t maxSerializedSize(const Rational& value, WireRadix radix = WireRadix::binary);
+
+// Как to_chars: при нехватке места - {last, value_too_large}
+std::to_chars_result serialize(char* first, char* last, const BigInteger& value, WireRadix radix = WireRadix::binary) {
+  uint64_t negative = static_cast<uint64_t>(!value.sign_);
+  if (radix == WireRadix::decimal) {
+    size_t count = (value == 0 ? 0 : value.digits_.size());
+    return writeLimbs<uint32_t>(first, last, (uint64_t(count) << 2) | 2 | negative, value.digits_.data(), count);
+  }
+  BinaryBigInteger binary(value);
+  const std::vector<uint64_t>& words = binary.words();
+  return writeLimbs<uint64_t>(first, last, (uint64_t(words.size()) << 2) | negative, words.data(), words.size());
+}
+
+// Как from_chars: на обрезанных или повреждённых данных - {first, invalid_argument}
+std::from_chars_result deserialize(const char* first, const char* last, BigInteger& value) {
+  uint64_t header = 0;
+  const char* begin = readVarint(first, last, header);
+  if (begin == nullptr) {
+    return {first, std::errc::invalid_argument};
+  }
+  uint64_t count = header >> 2;
+  size_t width = ((header & 2) != 0 ? 4 : 8);
+  bool negative = (header & 1) != 0;
+  if (static_cast<uint64_t>(last - begin) / width < count) {
+    return {first, std::errc::invalid_argument};
+  }
+  if (width == 8) {
+    std::vector<uint64_t> words(count);
+    for (size_t i = 0; i < count; ++i) {
+      words[i] = loadLittleEndian<uint64_t>(begin + 8 * i);
+    }
+    value = BinaryBigInteger::fromWords(std::move(words), negative).toBigInteger();
+    return {begin + 8 * count, std::errc()};
+  }
+  value.digits_.resize(std::max<size_t>(count, 1));
+  value.digits_[0] = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t limb = loadLittleEndian<uint32_t>(begin + 4 * i);
+    if (limb >= BigInteger::base) {
+      value = 0;
+      return {first, std::errc::invalid_argument};
+    }
+    value.digits_[i] = limb;
+  }
+  value.sign_ = !negative;
+  value.clear();
+  return {begin + 4 * count, std::errc()};
+}
+
+size_t maxSerializedSize(const Rational& value, WireRadix radix) {
+  return maxSerializedSize(value.numerator_, radix) + maxSerializedSize(value.denominator_, radix);
+}
+
+std::to_chars_result serialize(char* first, char* last, const Rational& value, WireRadix radix = WireRadix::binary) {
+  std::to_chars_result numerator = serialize(first, last, value.numerator_, radix);
+  if (numerator.ec != std::errc()) {
+    return numerator;
+  }
+  return serialize(numerator.ptr, last, value.denominator_, radix);
+}
+
+// Знаменатель должен быть положительным. Дробь не сокращается заново, кроме режима always
+std::from_chars_result deserialize(const char* first, const char* last, Rational& value) {
+  BigInteger numerator;
+  BigInteger denominator;
+  std::from_chars_result result = deserialize(first, last, numerator);
+  if (result.ec == std::errc()) {
+    result = deserialize(result.ptr, last, denominator);
+  }
+  if (result.ec != std::errc() or denominator <= 0) {
+    return {first, std::errc::invalid_argument};
+  }
+  value.numerator_ = std::move(numerator);
+  value.denominator_ = std::move(denominator);
+  if (Rational::normalization == Rational::Normalization::always) {
+    value.decrease();
+  } else {
+    value.reduced_length_ = Rational::length(value.denominator_);
+  }
+  return result;
+}
+
+// Потоковая запись чисел и последовательностей; буфер переиспользуется между вызовами
+class WireWriter {
+ public:
+
+  explicit WireWriter(std::ostream& out, WireRadix radix = WireRadix::binary) : out_(out), radix_(radix) {}
+
+  // BigInteger или Rational
+  template<class T>
+  WireWriter& write(const T& value) {
+    buffer_.resize(std::max(buffer_.size(), maxSerializedSize(value, radix_)));
+    std::to_chars_result result = serialize(buffer_.data(), buffer_.data() + buffer_.size(), value, radix_);
+    out_.write(buffer_.data(), result.ptr - buffer_.data());
+    return *this;
+  }
+
+  // Длина varint, затем элементы
+  template<class T>
+  WireWriter& write(const std::vector<T>& values) {
+    char header[10];
+    out_.write(header, writeVarint(header, header + sizeof(header), values.size()) - header);
+    for (const T& value : values) {
+      write(value);
+    }
+    return *this;
+  }
+
+ private:
+  std::ostream& out_;
+  WireRadix radix_;
+  std::vector<char> buffer_;
+};
+
+// Потоковое чтение; false - конец потока или повреждённые данные
+class WireReader {
+ public:
+
+  explicit WireReader(std::istream& in) : in_(in) {}
+
+  bool read(BigInteger& value) {
+    buffer_.clear();
+    return readNumber() and deserialize(buffer_.data(), buffer_.data() + buffer_.size(), value).ec == std::errc();
+  }
+
+  bool read(Rational& value) {
+    buffer_.clear();
+    return readNumber() and readNumber() and
+           deserialize(buffer_.data(), buffer_.data() + buffer_.size(), value).ec == std::errc();
+  }
+
+  template<class T>
+  bool read(std::vector<T>& values) {
+    uint64_t count = 0;
+    buffer_.clear();
+    if (!readHeader(count)) {
+      return false;
+    }
+    values.clear();
+    // Длине из потока не доверяем целиком: повреждённый заголовок не должен выделять гигабайты
+    values.reserve(std::min<uint64_t>(count, 4096));
+    for (; count > 0; --count) {
+      T value;
+      if (!read(value)) {
+        return false;
+      }
+      values.push_back(std::move(value));
+    }
+    return true;
+  }
+
+ private:
+  std::istream& in_;
+  std::vector<char> buffer_;
+
+  // Дописывает в buffer_ байты varint из потока и разбирает их
+  bool readHeader(uint64_t& value) {
+    size_t start = buffer_.size();
+    for (int byte = 0x80; byte >= 0x80; ) {
+      byte = in_.get();
+      if (byte == std::char_traits<char>::eof() or buffer_.size() - start == 10) {
+        return false;
+      }
+      buffer_.push_back(static_cast<char>(byte));
+    }
+    return readVarint(buffer_.data() + start, buffer_.data() + buffer_.size(), value) != nullptr;
+  }
+
+  // Дописывает в buffer_ заголовок и лимбы одного числа; лимбы читаются кусками,
+  // чтобы обрезанный поток с огромной длиной не выделял память заранее
+  bool readNumber() {
+    uint64_t header = 0;
+    if (!readHeader(header)) {
+      return false;
+    }
+    uint64_t width = ((header & 2) != 0 ? 4 : 8);
+    if ((header >> 2) > ~uint64_t(0) / width) {
+      return false;
+    }
+    for (uint64_t remaining = (header >> 2) * width; remaining > 0; ) {
+      size_t chunk = static_cast<size_t>(std::min<uint64_t>(remaining, size_t(1) << 20));
+      size_t offset = buffer_.size();
+      buffer_.resize(offset + chunk);
+      if (!in_.read(buffer_.data() + offset, static_cast<std::streamsize>(chunk))) {
+        return false;
+      }
+      remaining -= chunk;
+    }
+    return true;
+  }
+};
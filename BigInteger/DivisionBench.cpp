@@ -0,0 +1,72 @@
+// Деление через обратную величину по Ньютону против деления Кнута: частное и остаток
+// числа из 2m лимбов на число из m лимбов. Newton - newton_division_threshold = m (верхний
+// уровень через обратную величину), Knuth - порог m + 1. Предлагаемый порог - наименьшее m,
+// начиная с которого Ньютон выигрывает на всех больших размерах.
+// Запуск: ./DivisionBench [max_limbs] (по умолчанию 100000; Кнут на 100k лимбов идёт десятки секунд)
+#include "BigInteger_Rational.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+BigInteger randomLimbs(std::mt19937_64& rng, size_t limbs) {
+  std::string s(9 * limbs, '0');
+  for (char& c : s) {
+    c = static_cast<char>('0' + rng() % 10);
+  }
+  s[0] = '3';
+  return BigInteger(s);
+}
+
+// Среднее время divmod: повторы, пока не наберётся ~50 мс (но хотя бы один)
+double secondsPerDivision(const BigInteger& a, const BigInteger& b, BigInteger& quotient) {
+  size_t iterations = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    quotient = divmod(a, b).first;
+    ++iterations;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (elapsed < 0.05);
+  return elapsed / static_cast<double>(iterations);
+}
+
+int main(int argc, char** argv) {
+  size_t max_limbs = (argc > 1 ? std::stoull(argv[1]) : 100000);
+  const size_t saved = BigInteger::newton_division_threshold;
+  std::mt19937_64 rng(1);
+  std::cout << "newton_division_threshold (current " << saved << "), dividend 2m limbs / divisor m limbs\n";
+  std::cout << "       m       Knuth, ms      Newton, ms   speedup\n";
+  size_t suggested = 0;
+  const size_t sizes[] = {256, 512, 1000, 1500, 2048, 3000, 4096, 6000, 8192, 10000, 16384, 32768, 65536, 100000};
+  for (size_t m : sizes) {
+    if (m > max_limbs) {
+      break;
+    }
+    BigInteger b = randomLimbs(rng, m);
+    BigInteger a = randomLimbs(rng, 2 * m);
+    BigInteger knuth_quotient;
+    BigInteger newton_quotient;
+    BigInteger::newton_division_threshold = m + 1;
+    double knuth = secondsPerDivision(a, b, knuth_quotient);
+    BigInteger::newton_division_threshold = m;
+    double newton = secondsPerDivision(a, b, newton_quotient);
+    if (knuth_quotient != newton_quotient) {
+      std::cout << "quotients differ at m = " << m << '\n';
+      return 1;
+    }
+    if (newton >= knuth) {
+      suggested = 0;
+    } else if (suggested == 0) {
+      suggested = m;
+    }
+    std::printf("  %6zu  %14.2f  %14.2f  %8.2f\n", m, knuth * 1e3, newton * 1e3, knuth / newton);
+  }
+  BigInteger::newton_division_threshold = saved;
+  if (suggested != 0) {
+    std::cout << "suggested newton_division_threshold: " << suggested << '\n';
+  } else {
+    std::cout << "no crossover on this grid\n";
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+// Поиск порогов умножения на текущей машине. Для каждого порога и размера n (в лимбах)
+// сравнивается умножение n x n при threshold = n (верхний уровень - более быстрый алгоритм) и
+// threshold = n + 1 (верхний уровень - предыдущий); подзадачи меньше n, поэтому ниже оба
+// варианта совпадают. Предлагаемый порог - наименьшее n, начиная с которого быстрый алгоритм
+// выигрывает на всех больших размерах сетки.
+// Запуск: ./MulThresholdBench [karatsuba|toom3|ntt]; без аргумента - все три
+#include "BigInteger_Rational.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+BigInteger randomLimbs(std::mt19937_64& rng, size_t limbs) {
+  std::string s(9 * limbs, '0');
+  for (char& c : s) {
+    c = static_cast<char>('0' + rng() % 10);
+  }
+  s[0] = '7';
+  return BigInteger(s);
+}
+
+// Лучшее из нескольких замеров, каждый не короче ~20 мс
+double secondsPerMultiply(const BigInteger& a, const BigInteger& b) {
+  double best = std::numeric_limits<double>::max();
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    size_t iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+      BigInteger product = a;
+      product *= b;
+      ++iterations;
+      elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.02);
+    best = std::min(best, elapsed / static_cast<double>(iterations));
+  }
+  return best;
+}
+
+void findCrossover(const char* name, size_t& threshold, const std::vector<size_t>& sizes) {
+  const size_t saved = threshold;
+  std::mt19937_64 rng(1);
+  std::cout << name << "_threshold (current " << saved << ")\n";
+  std::cout << "  limbs      below, us      above, us    ratio\n";
+  size_t suggested = 0;
+  for (size_t n : sizes) {
+    BigInteger a = randomLimbs(rng, n);
+    BigInteger b = randomLimbs(rng, n);
+    threshold = n + 1;
+    double below = secondsPerMultiply(a, b);
+    threshold = n;
+    double above = secondsPerMultiply(a, b);
+    double ratio = above / below;
+    if (ratio >= 1) {
+      suggested = 0;
+    } else if (suggested == 0) {
+      suggested = n;
+    }
+    std::printf("  %6zu  %13.1f  %13.1f  %7.3f\n", n, below * 1e6, above * 1e6, ratio);
+  }
+  threshold = saved;
+  if (suggested != 0) {
+    std::cout << "  suggested " << name << "_threshold: " << suggested << "\n\n";
+  } else {
+    std::cout << "  no crossover on this grid\n\n";
+  }
+}
+
+std::vector<size_t> geometricSizes(size_t from, size_t to) {
+  std::vector<size_t> sizes;
+  for (double n = static_cast<double>(from); n <= static_cast<double>(to); n *= 1.25) {
+    if (sizes.empty() or static_cast<size_t>(n) != sizes.back()) {
+      sizes.push_back(static_cast<size_t>(n));
+    }
+  }
+  return sizes;
+}
+
+int main(int argc, char** argv) {
+  const char* only = (argc > 1 ? argv[1] : nullptr);
+  const size_t never = std::numeric_limits<size_t>::max();
+  const size_t karatsuba = BigInteger::karatsuba_threshold;
+  const size_t toom3 = BigInteger::toom3_threshold;
+  const size_t ntt = BigInteger::ntt_threshold;
+
+  if (only == nullptr or std::strcmp(only, "karatsuba") == 0) {
+    BigInteger::toom3_threshold = BigInteger::ntt_threshold = never;
+    findCrossover("karatsuba", BigInteger::karatsuba_threshold, geometricSizes(8, 256));
+  }
+  if (only == nullptr or std::strcmp(only, "toom3") == 0) {
+    BigInteger::karatsuba_threshold = karatsuba;
+    BigInteger::toom3_threshold = toom3;
+    BigInteger::ntt_threshold = never;
+    findCrossover("toom3", BigInteger::toom3_threshold, geometricSizes(64, 2048));
+  }
+  if (only == nullptr or std::strcmp(only, "ntt") == 0) {
+    BigInteger::karatsuba_threshold = karatsuba;
+    BigInteger::toom3_threshold = toom3;
+    BigInteger::ntt_threshold = ntt;
+    findCrossover("ntt", BigInteger::ntt_threshold, geometricSizes(256, 16384));
+  }
+  return 0;
+}
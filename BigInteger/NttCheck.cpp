@@ -0,0 +1,75 @@
+// Дифференциальная проверка умножения через NTT: произведения и квадраты случайных чисел и чисел
+// из одних девяток сравниваются с schoolbook (до schoolbook_limit лимбов) и с Карацубой/Тоом-3.
+// Запуск: ./NttCheck [seed] [rounds]; код возврата 1 при первом расхождении
+#include "BigInteger_Rational.cpp"
+
+#include <limits>
+#include <random>
+
+struct Thresholds {
+  size_t karatsuba;
+  size_t toom3;
+  size_t ntt;
+};
+
+BigInteger multiplyWith(const BigInteger& a, const BigInteger& b, Thresholds thresholds, bool square) {
+  BigInteger::karatsuba_threshold = thresholds.karatsuba;
+  BigInteger::toom3_threshold = thresholds.toom3;
+  BigInteger::ntt_threshold = thresholds.ntt;
+  BigInteger result = a;
+  if (square) {
+    result.square();
+  } else {
+    result *= b;
+  }
+  return result;
+}
+
+BigInteger randomNumber(std::mt19937_64& rng, size_t digits) {
+  std::string s(digits, '9');
+  if (rng() % 4 != 0) {
+    for (char& c : s) {
+      c = static_cast<char>('0' + rng() % 10);
+    }
+    s[0] = static_cast<char>('1' + rng() % 9);
+  }
+  if (rng() % 2 == 0) {
+    s.insert(s.begin(), '-');
+  }
+  return BigInteger(s);
+}
+
+int main(int argc, char** argv) {
+  uint64_t seed = (argc > 1 ? std::stoull(argv[1]) : 1);
+  size_t rounds = (argc > 2 ? std::stoull(argv[2]) : 200);
+  std::mt19937_64 rng(seed);
+  const size_t never = std::numeric_limits<size_t>::max();
+  const Thresholds defaults{BigInteger::karatsuba_threshold, BigInteger::toom3_threshold, BigInteger::ntt_threshold};
+  const Thresholds schoolbook{never, never, never};
+  const Thresholds no_ntt{defaults.karatsuba, defaults.toom3, never};
+  const Thresholds ntt_only{1, never, 1};
+  const size_t schoolbook_limit = 3000;
+  const size_t sizes[] = {1, 2, 3, 5, 17, 100, 1000, 2047, 2048, 5000, 20000, 100000};
+
+  for (size_t round = 0; round < rounds; ++round) {
+    // Длины в лимбах; иногда сильно несбалансированные
+    size_t n = sizes[rng() % (sizeof(sizes) / sizeof(sizes[0]))] + rng() % 7;
+    size_t m = (rng() % 3 == 0 ? 1 + rng() % 64 : sizes[rng() % (sizeof(sizes) / sizeof(sizes[0]))] + rng() % 7);
+    bool square = (rng() % 4 == 0);
+    BigInteger a = randomNumber(rng, 9 * n - rng() % 9);
+    BigInteger b = (square ? a : randomNumber(rng, 9 * m - rng() % 9));
+
+    BigInteger expected = multiplyWith(a, b, (std::max(n, m) <= schoolbook_limit ? schoolbook : no_ntt), square);
+    BigInteger actual = multiplyWith(a, b, ntt_only, square);
+    if (actual != expected or actual.toString() != expected.toString()) {
+      std::cout << "mismatch: seed " << seed << ", round " << round << ", limbs " << n << " x " << m
+                << (square ? " (square)" : "") << '\n';
+      return 1;
+    }
+  }
+  BigInteger::karatsuba_threshold = defaults.karatsuba;
+  BigInteger::toom3_threshold = defaults.toom3;
+  BigInteger::ntt_threshold = defaults.ntt;
+  std::cout << "OK: " << rounds << " products, seed " << seed << '\n';
+  return 0;
+}
@@ -0,0 +1,90 @@
+// Масштабирование параллельного умножения: два числа по digits десятичных цифр при
+// BigInteger::threads = 1, 2, 4, 8, 16, ускорение относительно одного потока. Затем поиск
+// parallel_threshold для workers потоков (по умолчанию - число ядер): parallel_threshold = m
+// против m + 1 на произведениях m x m лимбов.
+// Запуск: ./ParallelMulBench [digits] [workers]; по умолчанию 10^7 цифр
+#include "BigInteger_Rational.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+BigInteger randomDigits(std::mt19937_64& rng, size_t digits) {
+  std::string s(digits, '0');
+  for (char& c : s) {
+    c = static_cast<char>('0' + rng() % 10);
+  }
+  s[0] = '5';
+  return BigInteger(s);
+}
+
+double secondsPerMultiply(const BigInteger& a, const BigInteger& b, BigInteger& product, double at_least) {
+  size_t iterations = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    product = a;
+    product *= b;
+    ++iterations;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (elapsed < at_least);
+  return elapsed / static_cast<double>(iterations);
+}
+
+int main(int argc, char** argv) {
+  size_t digits = (argc > 1 ? std::stoull(argv[1]) : 10000000);
+  size_t workers = (argc > 2 ? std::stoull(argv[2]) : std::max<size_t>(1, std::thread::hardware_concurrency()));
+  const size_t saved_threads = BigInteger::threads;
+  const size_t saved_threshold = BigInteger::parallel_threshold;
+  std::mt19937_64 rng(1);
+
+  BigInteger a = randomDigits(rng, digits);
+  BigInteger b = randomDigits(rng, digits);
+  BigInteger reference;
+  std::cout << digits << " x " << digits << " digits, " << std::thread::hardware_concurrency() << " hardware threads\n";
+  std::cout << "  threads    seconds   speedup\n";
+  double sequential = 0;
+  for (size_t threads : {1, 2, 4, 8, 16}) {
+    BigInteger::threads = threads;
+    BigInteger product;
+    double seconds = secondsPerMultiply(a, b, product, 0);
+    if (threads == 1) {
+      sequential = seconds;
+      reference = product;
+    } else if (product != reference) {
+      std::cout << "product differs at " << threads << " threads\n";
+      return 1;
+    }
+    std::printf("  %7zu  %9.3f  %8.2f\n", threads, seconds, sequential / seconds);
+  }
+
+  std::cout << "\nparallel_threshold for " << workers << " threads (current " << saved_threshold << ")\n";
+  std::cout << "    limbs  sequential, ms  parallel, ms   speedup\n";
+  BigInteger::threads = workers;
+  size_t suggested = 0;
+  for (size_t m = 512; m <= 131072; m *= 2) {
+    BigInteger x = randomDigits(rng, 9 * m);
+    BigInteger y = randomDigits(rng, 9 * m);
+    BigInteger product;
+    BigInteger::parallel_threshold = m + 1;
+    double below = secondsPerMultiply(x, y, product, 0.05);
+    BigInteger::parallel_threshold = m;
+    double above = secondsPerMultiply(x, y, product, 0.05);
+    if (above >= below) {
+      suggested = 0;
+    } else if (suggested == 0) {
+      suggested = m;
+    }
+    std::printf("  %7zu  %14.2f  %12.2f  %8.2f\n", m, below * 1e3, above * 1e3, below / above);
+  }
+  if (workers == 1) {
+    std::cout << "one worker: parallel mode has nothing to gain\n";
+  } else if (suggested != 0) {
+    std::cout << "suggested parallel_threshold: " << suggested << '\n';
+  } else {
+    std::cout << "no crossover on this grid\n";
+  }
+  BigInteger::threads = saved_threads;
+  BigInteger::parallel_threshold = saved_threshold;
+  return 0;
+}
@@ -0,0 +1,111 @@
+// find и rfind на синтетическом журнале доступа (~8 МиБ) против старых циклов O(n * m):
+// прежний rfind проходил всю строку слева направо и запоминал последнее вхождение.
+// Иглы на 6, 8, 16 и 60 байт не встречаются в тексте (худший случай - просмотр всей строки),
+// последняя игла встречается. Результаты сверяются со старыми циклами.
+// Запуск: ./FindBench [megabytes]; по умолчанию 8
+#include "String.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+size_t naiveFind(const String& text, const String& sub) {
+  if (sub.size() > text.size()) {
+    return text.size();
+  }
+  for (size_t i = 0; i < (text.size() - sub.size() + 1); ++i) {
+    bool correct = true;
+    for (size_t j = 0; j < sub.size(); ++j) {
+      if (text[i + j] != sub[j]) {
+        correct = false;
+        break;
+      }
+    }
+    if (correct) {
+      return i;
+    }
+  }
+  return text.size();
+}
+
+size_t naiveRfind(const String& text, const String& sub) {
+  if (sub.size() > text.size()) {
+    return text.size();
+  }
+  size_t index = text.size();
+  for (size_t i = 0; i < (text.size() - sub.size() + 1); ++i) {
+    bool correct = true;
+    for (size_t j = 0; j < sub.size(); ++j) {
+      if (text[i + j] != sub[j]) {
+        correct = false;
+        break;
+      }
+    }
+    if (correct) {
+      index = i;
+    }
+  }
+  return index;
+}
+
+String accessLog(size_t bytes) {
+  const char* paths[] = {"/", "/index.html", "/api/v2/users", "/static/app.js", "/images/logo.png"};
+  const char* agents[] = {"Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)",
+                          "Mozilla/5.0 (Windows NT 10.0; Win64; x64) Gecko/20100101 Firefox/118.0",
+                          "curl/8.4.0"};
+  const int statuses[] = {200, 200, 200, 304, 404, 500};
+  std::mt19937 rng(1);
+  auto next = [&rng](unsigned bound) { return static_cast<unsigned>(rng() % bound); };
+  std::string log;
+  log.reserve(bytes + 256);
+  char line[512];
+  while (log.size() < bytes) {
+    int length = std::snprintf(line, sizeof(line),
+                               "10.%u.%u.%u - - [17/Oct/2026:09:%02u:%02u +0000] \"GET %s HTTP/1.1\" %d %u \"-\" \"%s\"\n",
+                               next(256), next(256), next(256), next(60), next(60), paths[next(5)], statuses[next(6)],
+                               next(100000), agents[next(3)]);
+    log.append(line, static_cast<size_t>(length));
+  }
+  return String(log.c_str());
+}
+
+template <class Search>
+double milliseconds(Search search, size_t& result) {
+  auto start = std::chrono::steady_clock::now();
+  result = search();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+  size_t megabytes = (argc > 1 ? std::stoull(argv[1]) : 8);
+  String text = accessLog(megabytes << 20);
+  std::cout << text.size() << " bytes of access log, milliseconds\n";
+  std::cout << "  length  naive find    find  naive rfind   rfind  position\n";
+  const char* needles[] = {"\" 503 ", "HTTP/1.0", "GET /admin/login",
+                           "Mozilla/5.0 (Macintosh; Intel Mac OS X 14_0) Safari/605.1.15",
+                           "/api/v2/users HTTP/1.1\" 404"};
+  for (const char* needle : needles) {
+    String sub(needle);
+    size_t naive_first = 0;
+    size_t first = 0;
+    size_t naive_last = 0;
+    size_t last = 0;
+    double naive_find_ms = milliseconds([&] { return naiveFind(text, sub); }, naive_first);
+    double find_ms = milliseconds([&] { return text.find(sub); }, first);
+    double naive_rfind_ms = milliseconds([&] { return naiveRfind(text, sub); }, naive_last);
+    double rfind_ms = milliseconds([&] { return text.rfind(sub); }, last);
+    if (first != naive_first or last != naive_last) {
+      std::cout << "results differ for \"" << needle << "\"\n";
+      return 1;
+    }
+    std::printf("  %6zu  %10.2f  %6.2f  %11.2f  %6.2f  ", sub.size(), naive_find_ms, find_ms, naive_rfind_ms,
+                rfind_ms);
+    if (first == text.size()) {
+      std::printf("none\n");
+    } else {
+      std::printf("%zu..%zu\n", first, last);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+// Выделения памяти и время циклов создание/копирование/+=/push_back/уничтожение для строк
+// разной длины: String против прежней реализации без SSO (OldString - её копия, урезанная до
+// используемых операций). До 23 символов String хранит строку в самом объекте и не должен
+// выделять память вовсе. Выделения считает подменённый operator new[].
+// Запуск: ./SsoBench [iterations]
+#include <cstdlib>
+#include <new>
+
+static size_t allocations = 0;
+
+// noinline: иначе GCC видит пару malloc/free через встроенные new/delete и ложно предупреждает
+__attribute__((noinline)) void* operator new[](size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+__attribute__((noinline)) void operator delete[](void* p, size_t) noexcept {
+  std::free(p);
+}
+
+#include "String.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Строка до SSO: всегда буфер в куче, в том числе у пустой
+class OldString {
+ private:
+  size_t sz = 0;
+  char* arr = nullptr;
+  size_t cap = 0;
+
+ public:
+  OldString(const char* cstr) : sz(strlen(cstr)), arr(new char[sz + 1]), cap(sz) {
+    memcpy(arr, cstr, sz + 1);
+  }
+
+  OldString() : sz(0), arr(new char[1]), cap(0) {
+    arr[0] = '\0';
+  }
+
+  OldString(const OldString& str) : sz(str.sz), arr(new char[str.cap + 1]), cap(str.cap) {
+    memcpy(arr, str.arr, sz + 1);
+  }
+
+  OldString& operator=(const OldString&) = delete;
+
+  ~OldString() {
+    delete[] arr;
+  }
+
+  size_t size() const {
+    return sz;
+  }
+
+  void push_back(char c) {
+    if (cap == 0) {
+      cap += 1;
+      sz += 1;
+      delete[] arr;
+      arr = new char[2];
+      arr[0] = c;
+      arr[1] = '\0';
+    } else if (cap == sz) {
+      cap *= 2;
+      char* temp_arr = new char[cap + 1];
+      memcpy(temp_arr, arr, sz + 1);
+      delete[] arr;
+      arr = temp_arr;
+      arr[sz] = c;
+      arr[sz + 1] = '\0';
+      ++sz;
+    } else {
+      arr[sz] = c;
+      arr[sz + 1] = '\0';
+      ++sz;
+    }
+  }
+
+  static size_t lower_bound(const size_t& x, const size_t& y) {
+    size_t border = y;
+    if (border == 0) { border += 1; }
+    while (true) {
+      if (border >= x) {
+        return border;
+      }
+      border <<= 1;
+    }
+  }
+
+  OldString& operator+=(const OldString& str) {
+    size_t temp_cap = lower_bound(sz + str.sz, cap);
+    char* temp_arr = new char[temp_cap + 1];
+    memcpy(temp_arr, arr, sz);
+    memcpy(temp_arr + sz, str.arr, str.sz + 1);
+    sz += str.sz;
+    cap = temp_cap;
+    delete[] arr;
+    arr = temp_arr;
+    return *this;
+  }
+};
+
+struct Measurement {
+  double allocations;
+  double nanoseconds;
+};
+
+template <class Str>
+Measurement measure(const std::string& text, size_t iterations) {
+  size_t before = allocations;
+  volatile size_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    Str a(text.c_str());
+    Str b = a;
+    Str c;
+    c += b;
+    Str d(c);
+    if (text.size() < 23) {
+      d.push_back('!');
+    }
+    sink = sink + d.size() + b.size();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double count = static_cast<double>(iterations);
+  return {static_cast<double>(allocations - before) / count, seconds * 1e9 / count};
+}
+
+int main(int argc, char** argv) {
+  size_t iterations = (argc > 1 ? std::stoull(argv[1]) : 2000000);
+  std::cout << iterations << " iterations of construct, copy, +=, push_back, destroy\n";
+  std::cout << "          allocations/iteration    ns/iteration\n";
+  std::cout << "  length    OldString     String  OldString  String\n";
+  size_t old_total = 0;
+  size_t new_total = 0;
+  int failures = 0;
+  for (size_t length : {0, 1, 8, 15, 22, 23, 24, 40, 100}) {
+    std::string text(length, 'x');
+    size_t before = allocations;
+    Measurement old_string = measure<OldString>(text, iterations);
+    old_total += allocations - before;
+    before = allocations;
+    Measurement string = measure<String>(text, iterations);
+    new_total += allocations - before;
+    std::printf("  %6zu  %11.2f  %9.2f  %9.1f  %6.1f\n", length, old_string.allocations, string.allocations,
+                old_string.nanoseconds, string.nanoseconds);
+    if (length <= 23 and allocations != before) {
+      ++failures;
+    }
+  }
+  std::cout << "total allocations: OldString " << old_total << ", String " << new_total << '\n';
+  if (failures != 0) {
+    std::cout << "short strings allocated\n";
+    return 1;
+  }
+  return 0;
+}
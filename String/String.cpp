@@ -1,135 +1,382 @@
 #include <iostream>
+#include <algorithm>
 #include <cstring>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 class String {
  private:
-  size_t sz = 0;
-  char* arr = nullptr;
-  size_t cap = 0;
+  //Строки до kInline символов хранятся прямо в объекте, без выделения памяти
+  static constexpr size_t kInline = 3 * sizeof(size_t) - 1;
+  static constexpr size_t kLongFlag = size_t(1) << (8 * sizeof(size_t) - 1);
+
+  struct Long {
+    char* arr;
+    size_t sz;
+    size_t cap; //Вместе с флагом kLongFlag
+  };
+
+  //Последний байт small у короткой строки равен kInline - sz, поэтому у строки длины kInline
+  //он же служит '\0'. У длинной строки на него приходится старший байт cap с флагом
+  union {
+    Long heap;
+    char small[kInline + 1];
+  };
+
+  static_assert(sizeof(Long) == kInline + 1, "SSO layout");
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "SSO flag lives in the last byte");
+
+  bool isLong() const {
+    return (static_cast<unsigned char>(small[kInline]) & 0x80) != 0;
+  }
+
+  //Строка длины n с неопределённым содержимым и '\0' в конце
+  void init(size_t n) {
+    if (n > kInline) {
+      heap.arr = new char[n + 1];
+      heap.sz = n;
+      heap.cap = n | kLongFlag;
+    } else {
+      small[kInline] = static_cast<char>(kInline - n);
+    }
+    data()[n] = '\0';
+  }
+
+  void setSize(size_t n) {
+    if (isLong()) {
+      heap.sz = n;
+    } else {
+      small[kInline] = static_cast<char>(kInline - n);
+    }
+    data()[n] = '\0';
+  }
+
+  //Образцы длиннее ищутся Бойером-Муром-Хорспулом, короче - фильтром по первому и
+  //последнему символу: на длинных образцах у фильтра много ложных срабатываний
+  static constexpr size_t kLongNeedle = 32;
+
+  //Первое вхождение sub[0..m) в text[0..n) или nullptr
+  static const char* searchForward(const char* text, size_t n, const char* sub, size_t m) {
+    if (m == 0) {
+      return text;
+    }
+    if (m > n) {
+      return nullptr;
+    }
+    if (m == 1) {
+      return static_cast<const char*>(memchr(text, sub[0], n));
+    }
+    if (m >= kLongNeedle) {
+      return horspoolForward(text, n, sub, m);
+    }
+    size_t i = 0;
+    //Блок позиций, где совпали и первый, и последний символ, проверяется memcmp
+#if defined(__AVX2__)
+    const __m256i first = _mm256_set1_epi8(sub[0]);
+    const __m256i last = _mm256_set1_epi8(sub[m - 1]);
+    for (; i + m + 31 <= n; i += 32) {
+      __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+      __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + m - 1));
+      uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))));
+      for (; mask != 0; mask &= mask - 1) {
+        size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+        if (memcmp(text + pos + 1, sub + 1, m - 2) == 0) {
+          return text + pos;
+        }
+      }
+    }
+#elif defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(sub[0]);
+    const __m128i last = _mm_set1_epi8(sub[m - 1]);
+    for (; i + m + 15 <= n; i += 16) {
+      __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+      __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + m - 1));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))));
+      for (; mask != 0; mask &= mask - 1) {
+        size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+        if (memcmp(text + pos + 1, sub + 1, m - 2) == 0) {
+          return text + pos;
+        }
+      }
+    }
+#endif
+    const char* end = text + n - m + 1;
+    for (const char* p = text + i; p < end; ++p) {
+      p = static_cast<const char*>(memchr(p, sub[0], static_cast<size_t>(end - p)));
+      if (p == nullptr) {
+        return nullptr;
+      }
+      if (p[m - 1] == sub[m - 1] and memcmp(p + 1, sub + 1, m - 2) == 0) {
+        return p;
+      }
+    }
+    return nullptr;
+  }
+
+  //Последнее вхождение sub[0..m) в text[0..n) или nullptr
+  static const char* searchBackward(const char* text, size_t n, const char* sub, size_t m) {
+    if (m == 0) {
+      return text + n;
+    }
+    if (m > n) {
+      return nullptr;
+    }
+    if (m >= kLongNeedle) {
+      return horspoolBackward(text, n, sub, m);
+    }
+    //Позиции [0, end) ещё не проверены
+    size_t end = n - m + 1;
+#if defined(__AVX2__)
+    const __m256i first = _mm256_set1_epi8(sub[0]);
+    const __m256i last = _mm256_set1_epi8(sub[m - 1]);
+    for (; end >= 32; end -= 32) {
+      size_t i = end - 32;
+      __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+      __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + m - 1));
+      uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last))));
+      for (; mask != 0; mask &= ~(uint32_t(1) << (31 - __builtin_clz(mask)))) {
+        size_t pos = i + static_cast<size_t>(31 - __builtin_clz(mask));
+        if (memcmp(text + pos, sub, m) == 0) {
+          return text + pos;
+        }
+      }
+    }
+#elif defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(sub[0]);
+    const __m128i last = _mm_set1_epi8(sub[m - 1]);
+    for (; end >= 16; end -= 16) {
+      size_t i = end - 16;
+      __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+      __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + m - 1));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))));
+      for (; mask != 0; mask &= ~(uint32_t(1) << (31 - __builtin_clz(mask)))) {
+        size_t pos = i + static_cast<size_t>(31 - __builtin_clz(mask));
+        if (memcmp(text + pos, sub, m) == 0) {
+          return text + pos;
+        }
+      }
+    }
+#endif
+    for (size_t pos = end; pos-- > 0; ) {
+      if (text[pos] == sub[0] and memcmp(text + pos, sub, m) == 0) {
+        return text + pos;
+      }
+    }
+    return nullptr;
+  }
+
+  //Сдвиг по символу текста под последним символом образца
+  static const char* horspoolForward(const char* text, size_t n, const char* sub, size_t m) {
+    size_t shift[256];
+    std::fill(shift, shift + 256, m);
+    for (size_t k = 0; k + 1 < m; ++k) {
+      shift[static_cast<unsigned char>(sub[k])] = m - 1 - k;
+    }
+    for (size_t i = 0; i + m <= n; i += shift[static_cast<unsigned char>(text[i + m - 1])]) {
+      if (text[i + m - 1] == sub[m - 1] and memcmp(text + i, sub, m - 1) == 0) {
+        return text + i;
+      }
+    }
+    return nullptr;
+  }
+
+  //Зеркально: сдвиг влево по символу текста под первым символом образца
+  static const char* horspoolBackward(const char* text, size_t n, const char* sub, size_t m) {
+    size_t shift[256];
+    std::fill(shift, shift + 256, m);
+    for (size_t k = m - 1; k > 0; --k) {
+      shift[static_cast<unsigned char>(sub[k])] = k;
+    }
+    for (size_t i = n - m; ; ) {
+      if (text[i] == sub[0] and memcmp(text + i + 1, sub + 1, m - 1) == 0) {
+        return text + i;
+      }
+      size_t step = shift[static_cast<unsigned char>(text[i])];
+      if (i < step) {
+        return nullptr;
+      }
+      i -= step;
+    }
+  }
+
+  //Переезд в новый буфер из new_cap + 1 байт, new_cap >= max(size(), kInline)
+  void reallocate(size_t new_cap) {
+    size_t n = size();
+    char* new_arr = new char[new_cap + 1];
+    if (isLong()) {
+      memcpy(new_arr, heap.arr, n + 1);
+      delete[] heap.arr;
+    } else {
+      memcpy(new_arr, small, kInline + 1); //new_cap >= kInline у короткой строки
+    }
+    new_arr[n] = '\0';
+    heap.arr = new_arr;
+    heap.sz = n;
+    heap.cap = new_cap | kLongFlag;
+  }
 
  public:
   //С-style конструктор
-  String(const char* cstr) : sz(strlen(cstr)), arr(new char[sz + 1]), cap(sz) {
-    memcpy(arr, cstr, sz + 1);
+  String(const char* cstr) {
+    size_t n = strlen(cstr);
+    init(n);
+    memcpy(data(), cstr, n);
   }
 
   //Конструктор для n элементов 'c':
-  String(size_t n, char c) : sz(n), arr(new char[n + 1]), cap(n) {
-    memset(arr, c, n);
-    arr[n] = '\0';
+  String(size_t n, char c) {
+    init(n);
+    memset(data(), c, n);
   }
 
   //Конструктор по умолчанию:
-  String() : sz(0), arr(new char[1]), cap(0) {
-    arr[0] = '\0';
+  String() {
+    init(0);
   }
 
   //Конструктор копирования:
-  String(const String& str) : sz(str.sz), arr(new char[str.cap + 1]), cap(str.cap) {
-    memcpy(arr, str.arr, sz + 1);
+  String(const String& str) {
+    init(str.size());
+    memcpy(data(), str.data(), str.size());
   }
   //Конструктор из чара (Можно и через конструктор для n элементов сделать):
-  String(const char& c) : sz(1), arr(new char[2]), cap(1) {
-    arr[0] = c;
-    arr[1] = '\0';
+  String(const char& c) {
+    init(1);
+    small[0] = c;
+  }
+  //Конструктор перемещения: забирает буфер, str остаётся пустой
+  String(String&& str) noexcept : heap(str.heap) {
+    str.init(0);
   }
   //Присваивание
   void swap(String& str) {
-    std::swap(arr, str.arr);
-    std::swap(sz, str.sz);
-    std::swap(cap, str.cap);
+    std::swap(heap, str.heap);
   }
 
-  String& operator=(String str) {
-    swap(str);
+  //Копирует в имеющийся буфер, если он вмещает str
+  String& operator=(const String& str) {
+    if (this == &str) {
+      return *this;
+    }
+    if (str.size() > capacity()) {
+      String copy = str;
+      swap(copy);
+    } else {
+      memcpy(data(), str.data(), str.size());
+      setSize(str.size());
+    }
+    return *this;
+  }
+
+  //Самоперемещение оставляет строку как есть
+  String& operator=(String&& str) noexcept {
+    if (this != &str) {
+      swap(str);
+      str.clear();
+    }
     return *this;
   }
 
   //Деструктор:
   ~String() {
-    delete[] arr;
+    if (isLong()) {
+      delete[] heap.arr;
+    }
   }
 
   bool empty() const {
-    return (sz == 0);
+    return (size() == 0);
   }
 
   void clear() {
-    sz = 0;
-    arr[0] = '\0';
+    setSize(0);
   }
 
   size_t size() const {
-    return sz;
+    return (isLong() ? heap.sz : kInline - static_cast<size_t>(small[kInline]));
   }
 
   size_t capacity() const {
-    return cap;
+    return (isLong() ? heap.cap & ~kLongFlag : kInline);
   }
 
   size_t length() const {
-    return sz;
+    return size();
   }
 
   char& operator[](size_t index) {
-    return arr[index];
+    return data()[index];
   }
 
   const char& operator[](size_t index) const {
-    return arr[index];
+    return data()[index];
   }
 
   void shrink_to_fit() {
-    char* new_arr = new char[sz + 1];
-    memcpy(new_arr, arr, sz + 1);
-    delete[] arr;
-    cap = sz;
-    arr = new_arr;
+    if (!isLong() or size() == capacity()) {
+      return;
+    }
+    size_t n = size();
+    if (n > kInline) {
+      reallocate(n);
+      return;
+    }
+    char* old_arr = heap.arr;
+    memcpy(small, old_arr, n);
+    small[n] = '\0';
+    small[kInline] = static_cast<char>(kInline - n);
+    delete[] old_arr;
+  }
+
+  void reserve(size_t new_cap) {
+    if (new_cap > capacity()) {
+      reallocate(new_cap);
+    }
   }
 
   void pop_back() {
-    sz -= 1;
-    arr[sz] = '\0';
+    setSize(size() - 1);
+  }
+
+  //Удаляет символы [start, start + count): хвост сдвигается одним memmove, размер меняется один раз
+  void erase(size_t start, size_t count) {
+    size_t n = size();
+    memmove(data() + start, data() + start + count, n - start - count);
+    setSize(n - count);
   }
 
   void push_back(char c) {
-    if (cap == 0) {
-      cap += 1;
-      sz += 1;
-      delete[] arr;
-      arr = new char[2];
-      arr[0] = c;
-      arr[1] = '\0';
-    } else if (cap == sz) {
-      cap *= 2;
-      char* temp_arr = new char[cap + 1];
-      memcpy(temp_arr, arr, sz + 1);
-      delete[] arr;
-      arr = temp_arr;
-      arr[sz] = c;
-      arr[sz + 1] = '\0';
-      ++sz;
-    } else {
-      arr[sz] = c;
-      arr[sz + 1] = '\0';
-      ++sz;
+    size_t n = size();
+    if (n == capacity()) {
+      reallocate(2 * n);
     }
+    data()[n] = c;
+    setSize(n + 1);
   }
 
   char& front() {
-    return arr[0];
+    return data()[0];
   }
 
   const char& front() const {
-    return arr[0];
+    return data()[0];
   }
 
   char& back() {
-    return arr[sz - 1];
+    return data()[size() - 1];
   }
 
   const char& back() const {
-    return arr[sz - 1];
+    return data()[size() - 1];
   }
 
   String& operator+=(char c) {
@@ -149,67 +396,50 @@ class String {
   }
 
   String& operator+=(const String& str) {
-    size_t temp_cap = lower_bound(sz + str.sz, cap);
+    size_t n = size();
+    size_t m = str.size();
+    if (n + m <= capacity()) {
+      memcpy(data() + n, str.data(), m);
+      setSize(n + m);
+      return *this;
+    }
+    //str может совпадать с *this: старый буфер освобождается только после копирования
+    size_t temp_cap = lower_bound(n + m, capacity());
     char* temp_arr = new char[temp_cap + 1];
-    memcpy(temp_arr, arr, sz);
-    memcpy(temp_arr + sz, str.arr, str.sz + 1);
-    sz += str.sz;
-    cap = temp_cap;
-    delete[] arr;
-    arr = temp_arr;
+    memcpy(temp_arr, data(), n);
+    memcpy(temp_arr + n, str.data(), m + 1);
+    if (isLong()) {
+      delete[] heap.arr;
+    }
+    heap.arr = temp_arr;
+    heap.sz = n + m;
+    heap.cap = temp_cap | kLongFlag;
     return *this;
   }
 
   size_t find(const String& sub) const {
-    if (sub.sz > sz) {
-      return sz;
-    }
-    for (size_t i = 0; i < (sz - sub.sz + 1); ++i) {
-      bool correct = true;
-      for (size_t j = 0; j < sub.sz; ++j) {
-        if (arr[i + j] != sub.arr[j]) {
-          correct = false;
-          break;
-        }
-      }
-      if (correct) {
-        return i;
-      }
-    }
-    return sz;
+    const char* pos = searchForward(data(), size(), sub.data(), sub.size());
+    return (pos == nullptr ? size() : static_cast<size_t>(pos - data()));
   }
 
+  //Последнее вхождение; поиск идёт с конца и останавливается на первом найденном
   size_t rfind(const String& sub) const {
-    if (sub.sz > sz) {
-      return sz;
-    }
-    size_t index = sz;
-    for (size_t i = 0; i < (sz - sub.sz + 1); ++i) {
-      bool correct = true;
-      for (size_t j = 0; j < sub.sz; ++j) {
-        if (arr[i + j] != sub.arr[j]) {
-          correct = false;
-          break;
-        }
-      }
-      if (correct) {
-        index = i;
-      }
-    }
-    return index;
+    const char* pos = searchBackward(data(), size(), sub.data(), sub.size());
+    return (pos == nullptr ? size() : static_cast<size_t>(pos - data()));
   }
+
   String substr(size_t start, size_t count) const {
     String tmp(count, '0');
-    memcpy(tmp.arr, arr + start, count + 1);
+    memcpy(tmp.data(), data() + start, count);
     return tmp;
   }
 
   char* data() {
-    return arr;
+    return (isLong() ? heap.arr : small);
   }
 
   const char* data() const {
-    return arr;
+    return (isLong() ? heap.arr : small);
   }
 
 };
@@ -255,17 +485,32 @@ bool operator!=(const String& str1, const String& str2) {
 }
 
 String operator+(const String& str1, const String& str2) {
-  String result = str1;
+  String result;
+  result.reserve(str1.size() + str2.size());
+  result += str1;
   result += str2;
   return result;
 }
 
+//Левый операнд - временный: a + b + c + d дописывает в один и тот же буфер
+String operator+(String&& str1, const String& str2) {
+  str1 += str2;
+  return std::move(str1);
+}
+
 String operator+(const String& str1, char c) {
-  String result = str1;
+  String result;
+  result.reserve(str1.size() + 1);
+  result += str1;
   result += c;
   return result;
 }
 
+String operator+(String&& str1, char c) {
+  str1 += c;
+  return std::move(str1);
+}
+
 String operator+(const char c, const String& str1) {
   String result(c);
   result += str1;
@@ -296,3 +541,611 @@ std::istream& operator>>(std::istream& in, String& str) {
     str.push_back(c);
   }
 }
+
+//Aho-Corasick: автомат строится один раз по набору образцов, scan находит все вхождения за один
+//проход. Переходы - полный ДКА в одном плоском массиве: строка на состояние, столбец на класс
+//байта (байты, не встречающиеся в образцах, - общий класс 0). Пустые образцы не находятся
+class AhoCorasick {
+ public:
+  struct Match {
+    size_t position; //Начало вхождения
+    size_t pattern; //Номер образца
+  };
+
+  explicit AhoCorasick(const std::vector<String>& patterns) {
+    std::fill(classes, classes + 256, 0);
+    for (const String& pattern : patterns) {
+      for (size_t i = 0; i < pattern.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(pattern[i]);
+        if (classes[c] == 0) {
+          classes[c] = static_cast<uint16_t>(++stride);
+        }
+      }
+    }
+    ++stride;
+    //Бор: next хранит номера состояний, 0 - перехода нет (в корень бор не ведёт)
+    next.assign(stride, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> terminals;
+    for (size_t id = 0; id < patterns.size(); ++id) {
+      const String& pattern = patterns[id];
+      lengths.push_back(pattern.size());
+      if (pattern.empty()) {
+        continue;
+      }
+      uint32_t state = 0;
+      for (size_t i = 0; i < pattern.size(); ++i) {
+        uint32_t& child = next[state * stride + classes[static_cast<unsigned char>(pattern[i])]];
+        if (child == 0) {
+          //Смещения строк занимают младшие 31 бит: states * stride должно быть меньше 2^31
+          if (next.size() + stride >= kReport) {
+            throw std::length_error("AhoCorasick: transition table exceeds 2^31 cells");
+          }
+          child = static_cast<uint32_t>(next.size() / stride);
+          next.resize(next.size() + stride, 0);
+        }
+        state = next[state * stride + classes[static_cast<unsigned char>(pattern[i])]];
+      }
+      terminals.emplace_back(state, static_cast<uint32_t>(id));
+    }
+    size_t states = next.size() / stride;
+    //Выходы состояний подряд: образцы состояния s лежат в outputs[output_start[s], output_start[s + 1])
+    output_start.assign(states + 1, 0);
+    for (const auto& terminal : terminals) {
+      ++output_start[terminal.first + 1];
+    }
+    for (size_t s = 0; s < states; ++s) {
+      output_start[s + 1] += output_start[s];
+    }
+    outputs.resize(terminals.size());
+    std::vector<uint32_t> cursor(output_start.begin(), output_start.end() - 1);
+    for (const auto& terminal : terminals) {
+      outputs[cursor[terminal.first]++] = terminal.second;
+    }
+    //Обход в ширину: суффиксные ссылки, словарные ссылки (ближайшее по суффиксным ссылкам
+    //состояние с выходом) и достраивание бора до ДКА
+    std::vector<uint32_t> fail(states, 0);
+    dictionary.assign(states, 0);
+    std::vector<uint32_t> queue;
+    for (size_t c = 0; c < stride; ++c) {
+      if (next[c] != 0) {
+        queue.push_back(next[c]);
+      }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+      uint32_t state = queue[head];
+      uint32_t link = fail[state];
+      dictionary[state] = (hasOutput(link) ? link : dictionary[link]);
+      for (size_t c = 0; c < stride; ++c) {
+        uint32_t& child = next[state * stride + c];
+        if (child != 0) {
+          fail[child] = next[link * stride + c];
+          queue.push_back(child);
+        } else {
+          child = next[link * stride + c];
+        }
+      }
+    }
+    //Номера состояний -> смещения строк, старший бит - в состоянии заканчивается образец
+    for (uint32_t& target : next) {
+      bool reports = hasOutput(target) or dictionary[target] != 0;
+      target = static_cast<uint32_t>(target * stride) | (reports ? kReport : 0);
+    }
+  }
+
+  size_t patternCount() const {
+    return lengths.size();
+  }
+
+  //Вызывает callback(position, pattern) для каждого вхождения в порядке их концов
+  template<class Callback>
+  void scan(const String& text, Callback&& callback) const {
+    const char* data = text.data();
+    uint32_t row = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+      uint32_t target = next[row + classes[static_cast<unsigned char>(data[i])]];
+      row = target & ~kReport;
+      if ((target & kReport) != 0) {
+        for (uint32_t state = static_cast<uint32_t>(row / stride); state != 0; state = dictionary[state]) {
+          for (uint32_t k = output_start[state]; k < output_start[state + 1]; ++k) {
+            callback(i + 1 - lengths[outputs[k]], static_cast<size_t>(outputs[k]));
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<Match> scan(const String& text) const {
+    std::vector<Match> matches;
+    scan(text, [&matches](size_t position, size_t pattern) {
+      matches.push_back({position, pattern});
+    });
+    return matches;
+  }
+
+  //Есть ли хоть одно вхождение: останавливается на первом
+  bool contains(const String& text) const {
+    const char* data = text.data();
+    uint32_t row = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+      uint32_t target = next[row + classes[static_cast<unsigned char>(data[i])]];
+      if ((target & kReport) != 0) {
+        return true;
+      }
+      row = target;
+    }
+    return false;
+  }
+
+ private:
+  static constexpr uint32_t kReport = uint32_t(1) << 31;
+
+  uint16_t classes[256]; //0 - байт не встречается в образцах
+  size_t stride = 0; //Число классов байтов, длина строки таблицы; в таблице меньше 2^31 ячеек (проверяется при построении)
+  std::vector<uint32_t> next;
+  std::vector<uint32_t> dictionary;
+  std::vector<uint32_t> output_start;
+  std::vector<uint32_t> outputs;
+  std::vector<size_t> lengths;
+
+  bool hasOutput(uint32_t state) const {
+    return output_start[state] != output_start[state + 1];
+  }
+};
+
+//Rope: текст как декартово дерево по неявному ключу из кусков String длиной до kMaxChunk.
+//Конкатенация, split, insert и erase - O(log n) ожидаемо; мелкие правки меняют кусок на месте.
+//После insert и erase куски у места правки не короче kMaxChunk / 2, если у них есть сосед
+class Rope {
+ private:
+  struct Node {
+    String chunk;
+    uint32_t priority;
+    size_t size_subtree; //Символов в поддереве
+    Node* left_child{nullptr};
+    Node* right_child{nullptr};
+  };
+
+ public:
+  static constexpr size_t kMaxChunk = 1024;
+
+  //Обход кусков слева направо
+  class ChunkIterator {
+   public:
+    const String& operator*() const {
+      return path.back()->chunk;
+    }
+
+    const String* operator->() const {
+      return &path.back()->chunk;
+    }
+
+    ChunkIterator& operator++() {
+      const Node* node = path.back();
+      path.pop_back();
+      descend(node->right_child);
+      return *this;
+    }
+
+    bool operator==(const ChunkIterator& other) const {
+      return path == other.path;
+    }
+
+    bool operator!=(const ChunkIterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    std::vector<const Node*> path; //Путь из ещё не пройденных предков, вершина - текущий кусок
+
+    explicit ChunkIterator(const Node* root) {
+      descend(root);
+    }
+
+    ChunkIterator() = default;
+
+    void descend(const Node* node) {
+      for (; node != nullptr; node = node->left_child) {
+        path.push_back(node);
+      }
+    }
+
+    friend class Rope;
+  };
+
+  Rope() = default;
+
+  explicit Rope(const String& str) {
+    append(str.data(), str.size());
+  }
+
+  Rope(const Rope& other) : root(copy(other.root)) {}
+
+  Rope(Rope&& other) noexcept : root(other.root) {
+    other.root = nullptr;
+  }
+
+  Rope& operator=(Rope other) {
+    std::swap(root, other.root);
+    return *this;
+  }
+
+  ~Rope() {
+    clear(root);
+  }
+
+  size_t size() const {
+    return sizeOf(root);
+  }
+
+  bool empty() const {
+    return root == nullptr;
+  }
+
+  char operator[](size_t index) const {
+    const Node* node = root;
+    while (true) {
+      size_t left = sizeOf(node->left_child);
+      if (index < left) {
+        node = node->left_child;
+      } else if (index < left + node->chunk.size()) {
+        return node->chunk[index - left];
+      } else {
+        index -= left + node->chunk.size();
+        node = node->right_child;
+      }
+    }
+  }
+
+  ChunkIterator begin() const {
+    return ChunkIterator(root);
+  }
+
+  ChunkIterator end() const {
+    return ChunkIterator();
+  }
+
+  //Конкатенация за O(log n): other остаётся пустым
+  Rope& operator+=(Rope&& other) {
+    root = merge(root, other.root);
+    other.root = nullptr;
+    return *this;
+  }
+
+  Rope& operator+=(const String& str) {
+    insert(size(), str);
+    return *this;
+  }
+
+  //Оставляет в *this первые position символов, остальное возвращает
+  Rope split(size_t position) {
+    std::pair<Node*, Node*> parts = splitAt(root, position);
+    root = parts.first;
+    Rope rest;
+    rest.root = parts.second;
+    return rest;
+  }
+
+  void insert(size_t position, const String& str) {
+    if (str.empty()) {
+      return;
+    }
+    if (root != nullptr and str.size() <= kMaxChunk / 2) {
+      //Полный кусок сначала делится пополам, чтобы правка поместилась в него на месте
+      if (insertInPlace(root, position, str)) {
+        return;
+      }
+      std::pair<Node*, Node*> parts = splitAt(root, chunkMiddle(root, position));
+      root = merge(parts.first, parts.second);
+      if (insertInPlace(root, position, str)) {
+        return;
+      }
+    }
+    std::pair<Node*, Node*> parts = splitAt(root, position);
+    Rope middle;
+    middle.append(str.data(), str.size());
+    root = merge(merge(parts.first, middle.root), parts.second);
+    middle.root = nullptr;
+    mergeUnderfull(position);
+    mergeUnderfull(position + str.size());
+  }
+
+  void erase(size_t position, size_t count) {
+    if (count == 0) {
+      return;
+    }
+    if (!eraseInPlace(root, position, count)) {
+      std::pair<Node*, Node*> right = splitAt(root, position + count);
+      std::pair<Node*, Node*> left = splitAt(right.first, position);
+      clear(left.second);
+      root = merge(left.first, right.second);
+    }
+    mergeUnderfull(position);
+  }
+
+  //Копия в один String: одно выделение памяти и копирование кусков подряд
+  String flatten() const {
+    String result;
+    result.reserve(size());
+    for (const String& chunk : *this) {
+      result += chunk;
+    }
+    return result;
+  }
+
+  String substr(size_t start, size_t count) const {
+    String result(count, '\0');
+    std::vector<const Node*> path;
+    //Спуск к куску с позицией start; предки, от которых ушли влево, идут в нём следующими
+    for (const Node* node = root; node != nullptr; ) {
+      size_t left = sizeOf(node->left_child);
+      if (start < left) {
+        path.push_back(node);
+        node = node->left_child;
+      } else if (start < left + node->chunk.size()) {
+        path.push_back(node);
+        start -= left;
+        break;
+      } else {
+        start -= left + node->chunk.size();
+        node = node->right_child;
+      }
+    }
+    ChunkIterator it;
+    it.path = std::move(path);
+    for (size_t filled = 0; filled < count; ++it, start = 0) {
+      size_t take = std::min(count - filled, it->size() - start);
+      memcpy(result.data() + filled, it->data() + start, take);
+      filled += take;
+    }
+    return result;
+  }
+
+ private:
+  Node* root = nullptr;
+  //Свой генератор у каждого потока: Rope в разных потоках не делят состояние
+  inline static thread_local std::minstd_rand generator;
+
+  static size_t sizeOf(const Node* node) {
+    return (node == nullptr ? 0 : node->size_subtree);
+  }
+
+  static void update(Node* node) {
+    node->size_subtree = sizeOf(node->left_child) + node->chunk.size() + sizeOf(node->right_child);
+  }
+
+  static Node* makeNode(String chunk) {
+    Node* node = new Node{std::move(chunk), static_cast<uint32_t>(generator()), 0};
+    update(node);
+    return node;
+  }
+
+  //Дописывает text[0..n) кусками по kMaxChunk / 2, оставляя место под вставки
+  void append(const char* text, size_t n) {
+    for (size_t i = 0; i < n; i += kMaxChunk / 2) {
+      size_t length = std::min(kMaxChunk / 2, n - i);
+      String chunk(length, '\0');
+      memcpy(chunk.data(), text + i, length);
+      root = merge(root, makeNode(std::move(chunk)));
+    }
+  }
+
+  //Первые position символов и остальное; кусок, через который идёт разрез, делится на два
+  static std::pair<Node*, Node*> splitAt(Node* node, size_t position) {
+    if (node == nullptr) {
+      return {nullptr, nullptr};
+    }
+    size_t left = sizeOf(node->left_child);
+    if (position <= left) {
+      std::pair<Node*, Node*> parts = splitAt(node->left_child, position);
+      node->left_child = parts.second;
+      update(node);
+      return {parts.first, node};
+    }
+    if (position >= left + node->chunk.size()) {
+      std::pair<Node*, Node*> parts = splitAt(node->right_child, position - left - node->chunk.size());
+      node->right_child = parts.first;
+      update(node);
+      return {node, parts.second};
+    }
+    size_t cut = position - left;
+    Node* tail = makeNode(node->chunk.substr(cut, node->chunk.size() - cut));
+    node->chunk = node->chunk.substr(0, cut);
+    Node* right = merge(tail, node->right_child);
+    node->right_child = nullptr;
+    update(node);
+    return {node, right};
+  }
+
+  static Node* merge(Node* tree1, Node* tree2) {
+    if (tree1 == nullptr) {
+      return tree2;
+    }
+    if (tree2 == nullptr) {
+      return tree1;
+    }
+    if (tree1->priority > tree2->priority) {
+      tree1->right_child = merge(tree1->right_child, tree2);
+      update(tree1);
+      return tree1;
+    }
+    tree2->left_child = merge(tree1, tree2->left_child);
+    update(tree2);
+    return tree2;
+  }
+
+  //Вставка внутрь куска, в который попадает позиция (включая его конец), если он не переполнится
+  static bool insertInPlace(Node* node, size_t position, const String& str) {
+    size_t left = sizeOf(node->left_child);
+    bool inserted = false;
+    if (position < left) {
+      inserted = insertInPlace(node->left_child, position, str);
+    } else if (position > left + node->chunk.size()) {
+      inserted = insertInPlace(node->right_child, position - left - node->chunk.size(), str);
+    } else if (node->chunk.size() + str.size() <= kMaxChunk) {
+      size_t cut = position - left;
+      size_t n = node->chunk.size();
+      node->chunk += str;
+      std::rotate(node->chunk.data() + cut, node->chunk.data() + n, node->chunk.data() + n + str.size());
+      inserted = true;
+    }
+    if (inserted) {
+      node->size_subtree += str.size();
+    }
+    return inserted;
+  }
+
+  //Удаление, целиком лежащее внутри одного куска и не опустошающее его
+  static bool eraseInPlace(Node* node, size_t position, size_t count) {
+    if (node == nullptr) {
+      return false;
+    }
+    size_t left = sizeOf(node->left_child);
+    bool erased = false;
+    if (position < left) {
+      erased = position + count <= left and eraseInPlace(node->left_child, position, count);
+    } else if (position >= left + node->chunk.size()) {
+      erased = eraseInPlace(node->right_child, position - left - node->chunk.size(), count);
+    } else if (position + count <= left + node->chunk.size() and count < node->chunk.size()) {
+      node->chunk.erase(position - left, count);
+      erased = true;
+    }
+    if (erased) {
+      node->size_subtree -= count;
+    }
+    return erased;
+  }
+
+  //Если кусок с символом position или position - 1 короче kMaxChunk / 2, он сливается с соседом,
+  //а если вместе они не помещаются в kMaxChunk - символы делятся между ними поровну.
+  //Каждый шаг либо убирает кусок, либо оставляет оба не короче половины, так что цикл конечен
+  void mergeUnderfull(size_t position) {
+    while (true) {
+      size_t total = size();
+      std::pair<size_t, size_t> underfull{0, 0};
+      for (size_t at : {position, position - 1}) {
+        if (at < total) {
+          std::pair<size_t, size_t> chunk = chunkBounds(root, at);
+          if (chunk.second - chunk.first < kMaxChunk / 2) {
+            underfull = chunk;
+            break;
+          }
+        }
+      }
+      if (underfull.first == underfull.second) {
+        return;
+      }
+      if (underfull.first > 0) {
+        rebalance(underfull.first);
+      } else if (underfull.second < total) {
+        rebalance(underfull.second);
+      } else {
+        return; //Кусок единственный
+      }
+    }
+  }
+
+  //Куски по обе стороны границы кусков boundary: слияние в один или поровну на два
+  void rebalance(size_t boundary) {
+    std::pair<Node*, Node*> parts = splitAt(root, boundary);
+    Node* left = popLast(parts.first);
+    Node* right = popFirst(parts.second);
+    size_t total = left->chunk.size() + right->chunk.size();
+    if (total <= kMaxChunk) {
+      left->chunk += right->chunk;
+      delete right;
+      right = nullptr;
+    } else if (left->chunk.size() > total / 2) {
+      size_t keep = total / 2;
+      String moved = left->chunk.substr(keep, left->chunk.size() - keep);
+      moved += right->chunk;
+      right->chunk = std::move(moved);
+      left->chunk.erase(keep, left->chunk.size() - keep);
+      update(right);
+    } else {
+      size_t take = total / 2 - left->chunk.size();
+      left->chunk += right->chunk.substr(0, take);
+      right->chunk.erase(0, take);
+      update(right);
+    }
+    update(left);
+    root = merge(merge(parts.first, left), merge(right, parts.second));
+  }
+
+  //Отцепляет от дерева самый левый кусок
+  static Node* popFirst(Node*& node) {
+    if (node->left_child == nullptr) {
+      Node* first = node;
+      node = node->right_child;
+      first->right_child = nullptr;
+      update(first);
+      return first;
+    }
+    Node* first = popFirst(node->left_child);
+    update(node);
+    return first;
+  }
+
+  //Отцепляет от дерева самый правый кусок
+  static Node* popLast(Node*& node) {
+    if (node->right_child == nullptr) {
+      Node* last = node;
+      node = node->left_child;
+      last->left_child = nullptr;
+      update(last);
+      return last;
+    }
+    Node* last = popLast(node->right_child);
+    update(node);
+    return last;
+  }
+
+  //Границы [начало, конец) куска, в котором лежит символ position < size()
+  static std::pair<size_t, size_t> chunkBounds(const Node* node, size_t position) {
+    size_t start = 0;
+    while (true) {
+      size_t left = sizeOf(node->left_child);
+      if (position < left) {
+        node = node->left_child;
+      } else if (position < left + node->chunk.size()) {
+        return {start + left, start + left + node->chunk.size()};
+      } else {
+        position -= left + node->chunk.size();
+        start += left + node->chunk.size();
+        node = node->right_child;
+      }
+    }
+  }
+
+  //Середина куска, в который insertInPlace вставлял бы на позиции position
+  static size_t chunkMiddle(const Node* node, size_t position) {
+    size_t start = 0;
+    while (true) {
+      size_t left = sizeOf(node->left_child);
+      if (position < left) {
+        node = node->left_child;
+      } else if (position > left + node->chunk.size()) {
+        position -= left + node->chunk.size();
+        start += left + node->chunk.size();
+        node = node->right_child;
+      } else {
+        return start + left + node->chunk.size() / 2;
+      }
+    }
+  }
+
+  static Node* copy(const Node* node) {
+    if (node == nullptr) {
+      return nullptr;
+    }
+    return new Node{node->chunk, node->priority, node->size_subtree, copy(node->left_child), copy(node->right_child)};
+  }
+
+  static void clear(Node* node) {
+    if (node == nullptr) {
+      return;
+    }
+    clear(node->left_child);
+    clear(node->right_child);
+    delete node;
+  }
+};